@@ -0,0 +1,234 @@
+#!/usr/bin/env python3
+
+"""
+Decompress a compressed ULog file (.ulgz, written with SDLOG_COMPRESS=1) into
+a regular ULog file (.ulg) that can be read by pyulog and other tools.
+
+The file consists of a header followed by independently heatshrink-compressed
+blocks. Data following the last valid block (e.g. appended after a crash) is
+not compressed and is copied as-is.
+
+Delta encoded data messages (SDLOG_DELTA=1) are expanded into regular data
+messages as well, which also works for uncompressed .ulg files.
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+COMPRESSED_MAGIC = b'ULogZip'
+COMPRESSION_HEATSHRINK = 1
+
+# struct ulog_compressed_header_s
+HEADER_FORMAT = '<7sBBBBBH'
+HEADER_SIZE = struct.calcsize(HEADER_FORMAT)
+
+# struct ulog_compressed_block_s
+BLOCK_FORMAT = '<HH'
+BLOCK_SIZE = struct.calcsize(BLOCK_FORMAT)
+
+ULOG_FILE_HEADER_SIZE = 16
+ULOG_MSG_HEADER_LEN = 3
+MSG_TYPE_DATA = ord('D')
+MSG_TYPE_DATA_DELTA = ord('X')
+MSG_TYPE_FLAG_BITS = ord('B')
+INCOMPAT_FLAG0_DATA_DELTA_MASK = 1 << 1
+
+
+def heatshrink_decode(data, window_bits, lookahead_bits):
+    """ decode a complete heatshrink stream """
+    output = bytearray()
+    bit_index = 0
+    total_bits = len(data) * 8
+
+    def read_bits(count):
+        nonlocal bit_index
+        if bit_index + count > total_bits:
+            return None
+        value = 0
+        for _ in range(count):
+            byte = data[bit_index >> 3]
+            value = (value << 1) | ((byte >> (7 - (bit_index & 7))) & 1)
+            bit_index += 1
+        return value
+
+    while True:
+        tag = read_bits(1)
+        if tag is None:
+            break
+
+        if tag:  # literal
+            value = read_bits(8)
+            if value is None:
+                break
+            output.append(value)
+
+        else:  # back reference
+            index = read_bits(window_bits)
+            count = read_bits(lookahead_bits)
+            if index is None or count is None:
+                break
+            offset = index + 1
+            for _ in range(count + 1):
+                # the decoder's window starts zero-initialized
+                output.append(output[-offset] if offset <= len(output) else 0)
+
+    return output
+
+
+def decompress(data):
+    """ decompress a compressed log, returns the ULog data """
+    if len(data) < HEADER_SIZE:
+        raise ValueError('file too short')
+
+    magic, hdr_ver, algorithm, window_bits, lookahead_bits, _, block_size = \
+        struct.unpack_from(HEADER_FORMAT, data, 0)
+
+    if magic != COMPRESSED_MAGIC:
+        raise ValueError('not a compressed ULog file')
+
+    if algorithm != COMPRESSION_HEATSHRINK:
+        raise ValueError('unsupported compression algorithm {}'.format(algorithm))
+
+    output = bytearray()
+    offset = HEADER_SIZE
+
+    while offset + BLOCK_SIZE <= len(data):
+        compressed_size, uncompressed_size = struct.unpack_from(BLOCK_FORMAT, data, offset)
+        block_end = offset + BLOCK_SIZE + compressed_size
+
+        if uncompressed_size == 0 or uncompressed_size > block_size or block_end > len(data):
+            break
+
+        block = heatshrink_decode(data[offset + BLOCK_SIZE:block_end], window_bits, lookahead_bits)
+
+        if len(block) != uncompressed_size:
+            break
+
+        output += block
+        offset = block_end
+
+    if offset < len(data):
+        print('copying {} bytes of trailing data'.format(len(data) - offset))
+        output += data[offset:]
+
+    return output
+
+
+def expand_delta(data):
+    """ replace DATA_DELTA messages with regular DATA messages, returns None if the log has none """
+    if len(data) < ULOG_FILE_HEADER_SIZE + ULOG_MSG_HEADER_LEN + 40:
+        return None
+
+    flag_bits_offset = ULOG_FILE_HEADER_SIZE
+    msg_size, msg_type = struct.unpack_from('<HB', data, flag_bits_offset)
+    incompat_offset = flag_bits_offset + ULOG_MSG_HEADER_LEN + 8
+    if msg_type != MSG_TYPE_FLAG_BITS or not data[incompat_offset] & INCOMPAT_FLAG0_DATA_DELTA_MASK:
+        return None
+
+    appended_offsets_offset = incompat_offset + 8
+    appended_offsets = list(struct.unpack_from('<QQQ', data, appended_offsets_offset))
+    new_appended_offsets = list(appended_offsets)
+
+    output = bytearray(data[:ULOG_FILE_HEADER_SIZE])
+    samples = {}  # last sample per msg_id
+    offset = ULOG_FILE_HEADER_SIZE
+
+    while offset + ULOG_MSG_HEADER_LEN <= len(data):
+        for i, appended_offset in enumerate(appended_offsets):
+            if appended_offset == offset:
+                new_appended_offsets[i] = len(output)
+
+        msg_size, msg_type = struct.unpack_from('<HB', data, offset)
+        msg_end = offset + ULOG_MSG_HEADER_LEN + msg_size
+        if msg_end > len(data):
+            break
+
+        if msg_type == MSG_TYPE_DATA and msg_size >= 2:
+            msg_id, = struct.unpack_from('<H', data, offset + ULOG_MSG_HEADER_LEN)
+            samples[msg_id] = bytearray(data[offset + ULOG_MSG_HEADER_LEN + 2:msg_end])
+            output += data[offset:msg_end]
+
+        elif msg_type == MSG_TYPE_DATA_DELTA and msg_size >= 2:
+            msg_id, = struct.unpack_from('<H', data, offset + ULOG_MSG_HEADER_LEN)
+            sample = samples.get(msg_id)
+            pos = offset + ULOG_MSG_HEADER_LEN + 2
+            valid = sample is not None
+
+            while valid and pos + 3 <= msg_end:
+                run_offset, run_length = struct.unpack_from('<HB', data, pos)
+                pos += 3
+                if pos + run_length > msg_end or run_offset + run_length > len(sample):
+                    valid = False
+                    break
+                for i in range(run_length):
+                    sample[run_offset + i] ^= data[pos + i]
+                pos += run_length
+
+            if valid and pos == msg_end:
+                output += struct.pack('<HBH', len(sample) + 2, MSG_TYPE_DATA, msg_id) + sample
+            else:
+                print('skipping invalid delta message at offset {}'.format(offset))
+                samples.pop(msg_id, None)
+
+        else:
+            output += data[offset:msg_end]
+
+        offset = msg_end
+
+    output += data[offset:]
+
+    # the file does not contain delta messages anymore
+    output[incompat_offset] &= ~INCOMPAT_FLAG0_DATA_DELTA_MASK & 0xff
+    struct.pack_into('<QQQ', output, appended_offsets_offset, *new_appended_offsets)
+    return output
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decompress a compressed (.ulgz) or delta encoded ULog file')
+    parser.add_argument('input', help='compressed or delta encoded log file')
+    parser.add_argument('output', nargs='?', help='output file (default: input file name with .ulg extension, '
+                        'which must not exist yet)')
+    args = parser.parse_args()
+
+    output_file = args.output
+    if output_file is None:
+        if args.input.endswith('.ulgz'):
+            output_file = args.input[:-1]
+        elif args.input.endswith('.ulg'):
+            output_file = args.input[:-4] + '_expanded.ulg'
+        else:
+            output_file = args.input + '.ulg'
+        if os.path.exists(output_file):
+            print('Error: {} already exists, pass the output file explicitly'.format(output_file))
+            sys.exit(1)
+
+    with open(args.input, 'rb') as f:
+        data = f.read()
+
+    if data.startswith(COMPRESSED_MAGIC):
+        try:
+            output = decompress(data)
+        except ValueError as e:
+            print('Error: {}'.format(e))
+            sys.exit(1)
+    else:
+        output = data
+
+    expanded = expand_delta(output)
+    if expanded is not None:
+        output = expanded
+    elif output is data:
+        print('Error: neither compressed nor delta encoded')
+        sys.exit(1)
+
+    with open(output_file, 'wb') as f:
+        f.write(output)
+
+    print('Wrote {} ({} bytes, compression ratio {:.2f})'.format(
+        output_file, len(output), len(output) / max(len(data), 1)))
+
+
+if __name__ == '__main__':
+    main()
@@ -31,7 +31,8 @@ class LoggingCompleted(Exception):
 class MavlinkLogStreaming():
     '''Streams log data via MAVLink.
        Assumptions:
-       - the sender only sends one acked message at a time
+       - acked messages that arrive out of order (because an earlier one was
+         lost and is retransmitted) are reordered, up to a window of 16
        - the data is in the ULog format '''
     def __init__(self, portname, baudrate, output_filename, debug=0):
         self.baudrate = 0
@@ -51,6 +52,8 @@ class MavlinkLogStreaming():
         self.last_sequence = -1
         self.logging_started = False
         self.num_dropouts = 0
+        self.reordered = {} # sequence -> message received ahead of a lost acked message
+        self.flush_reordered = False
         self.target_component = 1
         self.got_sig_int = False
 
@@ -121,6 +124,19 @@ class MavlinkLogStreaming():
     def read_message(self):
         ''' read a single mavlink message, handle ACK & return a tuple of (data, first
         message start, num dropouts) '''
+        if len(self.reordered) > 0:
+            next_sequence = (self.last_sequence + 1) & 0xffff
+            if next_sequence in self.reordered or self.flush_reordered:
+                # deliver the oldest one, if the gap was not filled the
+                # messages are treated as dropped
+                sequence = min(self.reordered,
+                        key=lambda seq: (seq - self.last_sequence) & 0xffff)
+                m = self.reordered.pop(sequence)
+                _, num_drops = self.check_sequence(sequence)
+                if len(self.reordered) == 0:
+                    self.flush_reordered = False
+                return self.deliver_message(m, num_drops)
+
         m = self.mav.recv_match(type=['LOGGING_DATA_ACKED',
                             'LOGGING_DATA', 'COMMAND_ACK'], blocking=True,
                             timeout=0.05)
@@ -150,17 +166,19 @@ class MavlinkLogStreaming():
                         self.target_component, m.sequence)
 
             if is_newer:
-                if num_drops > 0:
-                    self.num_dropouts += num_drops
-
-                if m.get_type() == 'LOGGING_DATA':
-                    if not self.got_header_section:
-                        print('Header received in {:0.2f}s (size: {:.1f} KB)'.format(
-                              timer()-self.start_time, self.file.tell()/1024))
-                        self.logging_started = True
-                        self.got_header_section = True
-                self.last_sequence = m.sequence
-                return m.data[:m.length], m.first_message_offset, num_drops
+                if num_drops > 0 or len(self.reordered) > 0:
+                    if m.get_type() == 'LOGGING_DATA_ACKED' and len(self.reordered) < 16:
+                        # an earlier acked message is missing: wait for its retransmission
+                        self.reordered[m.sequence] = m
+                        return None, 0, 0
+                    # the sender only continues with unacked data once all
+                    # acked messages got through, so the gap is not going to
+                    # be filled anymore
+                    self.reordered[m.sequence] = m
+                    self.flush_reordered = True
+                    return None, 0, 0
+
+                return self.deliver_message(m, num_drops)
 
             else:
                 self.debug('dup/reordered message '+str(m.sequence))
@@ -168,6 +186,22 @@ class MavlinkLogStreaming():
         return None, 0, 0
 
 
+    def deliver_message(self, m, num_drops):
+        ''' accept the next message in sequence & return a tuple of (data, first
+        message start, num dropouts) '''
+        if num_drops > 0:
+            self.num_dropouts += num_drops
+
+        if m.get_type() == 'LOGGING_DATA':
+            if not self.got_header_section:
+                print('Header received in {:0.2f}s (size: {:.1f} KB)'.format(
+                      timer()-self.start_time, self.file.tell()/1024))
+                self.logging_started = True
+                self.got_header_section = True
+        self.last_sequence = m.sequence
+        return m.data[:m.length], m.first_message_offset, num_drops
+
+
     def check_sequence(self, seq):
         ''' check if a sequence is newer than the previously received one & if
         there were dropped messages between the last and this '''
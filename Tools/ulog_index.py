@@ -0,0 +1,159 @@
+#!/usr/bin/env python3
+
+"""
+Read the index of a ULog file (written with SDLOG_INDEX=1) and print where the
+topics are located, without scanning the file.
+
+Examples:
+    ulog_index.py log.ulg                        # list the topics and index blocks
+    ulog_index.py log.ulg -t sensor_combined -s 120
+        # file offset of a sensor_combined sample shortly before t=120 s
+
+Compressed logs (.ulgz) need to be decompressed first (Tools/decompress_ulog.py).
+"""
+
+import argparse
+import struct
+import sys
+
+ULOG_FILE_HEADER_SIZE = 16
+ULOG_MSG_HEADER_FORMAT = '<HB'
+ULOG_MSG_HEADER_LEN = 3
+MSG_TYPE_ADD_LOGGED = ord('A')
+MSG_TYPE_DATA = ord('D')
+MSG_TYPE_INDEX = ord('N')
+MSG_TYPE_INDEX_FOOTER = ord('E')
+
+# struct ulog_message_index_s (after the message header)
+INDEX_FORMAT = '<QQQ'
+INDEX_SIZE = ULOG_MSG_HEADER_LEN + struct.calcsize(INDEX_FORMAT)
+
+# struct ulog_message_index_entry_s
+ENTRY_FORMAT = '<BHQQ'
+ENTRY_SIZE = struct.calcsize(ENTRY_FORMAT)
+
+# struct ulog_message_index_footer_s
+FOOTER_FORMAT = '<HBQ8s'
+FOOTER_SIZE = struct.calcsize(FOOTER_FORMAT)
+FOOTER_MAGIC = b'ULogIdx'
+
+MAX_SEARCH_SIZE = 64 * 1024 * 1024
+
+
+def read_index_message(data, offset):
+    """ returns (previous_index_offset, timestamp, entries) or None if there is no valid index message """
+    if offset + INDEX_SIZE > len(data):
+        return None
+
+    msg_size, msg_type = struct.unpack_from(ULOG_MSG_HEADER_FORMAT, data, offset)
+    own_offset, previous_offset, timestamp = struct.unpack_from(INDEX_FORMAT, data, offset + ULOG_MSG_HEADER_LEN)
+    msg_end = offset + ULOG_MSG_HEADER_LEN + msg_size
+
+    if msg_type != MSG_TYPE_INDEX or own_offset != offset or msg_end > len(data) or \
+            msg_size + ULOG_MSG_HEADER_LEN < INDEX_SIZE:
+        return None
+
+    num_entries = (msg_size + ULOG_MSG_HEADER_LEN - INDEX_SIZE) // ENTRY_SIZE
+    entries = [struct.unpack_from(ENTRY_FORMAT, data, offset + INDEX_SIZE + i * ENTRY_SIZE)
+               for i in range(num_entries)]
+    return previous_offset, timestamp, entries
+
+
+def find_last_index(data):
+    """ file offset of the last index message, via the footer or by searching backwards """
+    if len(data) >= FOOTER_SIZE:
+        msg_size, msg_type, index_offset, magic = struct.unpack_from(FOOTER_FORMAT, data, len(data) - FOOTER_SIZE)
+        if msg_type == MSG_TYPE_INDEX_FOOTER and msg_size == FOOTER_SIZE - ULOG_MSG_HEADER_LEN and \
+                magic.startswith(FOOTER_MAGIC) and read_index_message(data, index_offset) is not None:
+            return index_offset
+
+    # truncated log
+    pos = data.rfind(bytes([MSG_TYPE_INDEX]), 0, len(data))
+    while pos >= max(len(data) - MAX_SEARCH_SIZE, 2):
+        if read_index_message(data, pos - 2) is not None:
+            return pos - 2
+        pos = data.rfind(bytes([MSG_TYPE_INDEX]), 0, pos)
+
+    return None
+
+
+def read_index(data):
+    """ returns the list of index blocks (offset, timestamp, entries) in file order, or None """
+    offset = find_last_index(data)
+    if offset is None:
+        return None
+
+    blocks = []
+    while offset > 0:
+        index = read_index_message(data, offset)
+        if index is None:
+            print('Invalid index message at offset {}'.format(offset))
+            return None
+        previous_offset, timestamp, entries = index
+        blocks.append((offset, timestamp, entries))
+        if previous_offset >= offset:
+            return None
+        offset = previous_offset
+
+    blocks.reverse()
+    return blocks
+
+
+def read_subscriptions(data, blocks):
+    """ msg_id -> (topic name, multi_id), reading only the indexed subscription messages """
+    subscriptions = {}
+    for _, _, entries in blocks:
+        for msg_type, msg_id, offset, _ in entries:
+            if msg_type != MSG_TYPE_ADD_LOGGED:
+                continue
+            msg_size, = struct.unpack_from('<H', data, offset)
+            multi_id, = struct.unpack_from('<B', data, offset + ULOG_MSG_HEADER_LEN)
+            name = data[offset + ULOG_MSG_HEADER_LEN + 3:offset + ULOG_MSG_HEADER_LEN + msg_size]
+            subscriptions[msg_id] = (name.decode('utf-8', 'replace'), multi_id)
+    return subscriptions
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Print the index of a ULog file')
+    parser.add_argument('input', help='ULog file')
+    parser.add_argument('-t', '--topic', help='topic name (multi instances are listed separately)')
+    parser.add_argument('-s', '--start', type=float, default=None,
+                        help='with --topic: find the last indexed sample before this time [s]')
+    args = parser.parse_args()
+
+    with open(args.input, 'rb') as f:
+        data = f.read()
+
+    blocks = read_index(data)
+    if not blocks:
+        print('Error: the log has no index')
+        sys.exit(1)
+
+    subscriptions = read_subscriptions(data, blocks)
+    print('{} index blocks, {:.1f} s - {:.1f} s, not indexed after offset {} ({} bytes)'.format(
+        len(blocks), blocks[0][1] / 1e6, blocks[-1][1] / 1e6, blocks[-1][0], len(data) - blocks[-1][0]))
+
+    if args.topic is None:
+        for msg_id, (name, multi_id) in sorted(subscriptions.items()):
+            print('{:5d}: {} ({})'.format(msg_id, name, multi_id))
+        return
+
+    for msg_id, (name, multi_id) in sorted(subscriptions.items()):
+        if name != args.topic:
+            continue
+
+        samples = [(timestamp, offset) for _, _, entries in blocks
+                   for msg_type, entry_msg_id, offset, timestamp in entries
+                   if msg_type == MSG_TYPE_DATA and entry_msg_id == msg_id]
+
+        if args.start is not None:
+            before = [sample for sample in samples if sample[0] <= args.start * 1e6]
+            samples = before[-1:] if before else samples[:1]
+
+        print('{} ({}), msg_id {}:'.format(name, multi_id, msg_id))
+        for timestamp, offset in samples:
+            print('  {:12.6f} s at offset {}'.format(timestamp / 1e6, offset))
+
+
+if __name__ == '__main__':
+    main()
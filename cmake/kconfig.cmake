@@ -24,6 +24,7 @@ set(COMMON_KCONFIG_ENV_SETTINGS
 	LABEL=${PX4_BOARD_LABEL}
 	TOOLCHAIN=${CMAKE_TOOLCHAIN_FILE}
 	ARCHITECTURE=${CMAKE_SYSTEM_PROCESSOR}
+	HOST_SYSTEM=${CMAKE_HOST_SYSTEM_NAME}
 	ROMFSROOT=${config_romfs_root}
 	BASE_DEFCONFIG=${BOARD_CONFIG}
 )
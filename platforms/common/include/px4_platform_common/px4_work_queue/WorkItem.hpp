@@ -42,6 +42,7 @@
 #include <drivers/drv_hrt.h>
 #include <lib/mathlib/mathlib.h>
 #include <lib/perf/perf_counter.h>
+#include <lib/perf/LatencyHistogram.hpp>
 
 #include <string.h>
 
@@ -83,6 +84,15 @@ public:
 
 	const char *ItemName() const { return _item_name; }
 
+#if defined(CONFIG_PX4_WORK_QUEUE_LATENCY)
+	static constexpr int LATENCY_HISTOGRAM_BUCKETS = 16;
+
+	using SchedulingLatencyHistogram = LatencyHistogram<LATENCY_HISTOGRAM_BUCKETS>;
+
+	/** Scheduling latency histogram (ScheduleNow() until Run()) since the item was initialized. */
+	const SchedulingLatencyHistogram &latency_histogram() const { return _latency_histogram; }
+#endif // CONFIG_PX4_WORK_QUEUE_LATENCY
+
 protected:
 
 	explicit WorkItem(const char *name, const wq_config_t &config);
@@ -97,7 +107,10 @@ protected:
 	void ScheduleClear();
 protected:
 
-	void RunPreamble()
+	/**
+	 * @param time_scheduled time the item was added to the run queue, 0 if unknown
+	 */
+	void RunPreamble(hrt_abstime time_scheduled)
 	{
 		if (_run_count == 0) {
 			_time_first_run = hrt_absolute_time();
@@ -106,9 +119,22 @@ protected:
 		} else {
 			_run_count++;
 		}
+
+#if defined(CONFIG_PX4_WORK_QUEUE_LATENCY)
+
+		// scheduling latency (ScheduleNow() until Run())
+		if (time_scheduled != 0) {
+			const uint32_t latency = hrt_absolute_time() - time_scheduled;
+			_latency_sum += latency;
+			_latency_histogram.add(latency);
+		}
+
+#else
+		(void)time_scheduled;
+#endif // CONFIG_PX4_WORK_QUEUE_LATENCY
 	}
 
-	friend void WorkQueue::Run();
+	friend class WorkQueue;
 	virtual void Run() = 0;
 
 	/**
@@ -125,11 +151,20 @@ protected:
 	float elapsed_time() const;
 	float average_rate() const;
 	float average_interval() const;
+#if defined(CONFIG_PX4_WORK_QUEUE_LATENCY)
+	float average_latency() const;
+#endif // CONFIG_PX4_WORK_QUEUE_LATENCY
 
 	hrt_abstime	_time_first_run{0};
 	const char 	*_item_name;
 	uint32_t	_run_count{0};
 
+#if defined(CONFIG_PX4_WORK_QUEUE_LATENCY)
+	hrt_abstime	_time_scheduled{0}; ///< time the item was added to the run queue (protected by the WorkQueue lock)
+	uint64_t	_latency_sum{0}; ///< since the item was initialized, like the histogram
+	SchedulingLatencyHistogram _latency_histogram{};
+#endif // CONFIG_PX4_WORK_QUEUE_LATENCY
+
 private:
 
 	WorkQueue	*_wq{nullptr};
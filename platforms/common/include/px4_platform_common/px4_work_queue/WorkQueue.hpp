@@ -51,7 +51,10 @@ class WorkItem;
 class WorkQueue : public IntrusiveSortedListNode<WorkQueue *>
 {
 public:
-	explicit WorkQueue(const wq_config_t &wq_config);
+	/**
+	 * @param pooled run by the work queue pool instead of a dedicated thread (CONFIG_PX4_WORK_QUEUE_POOL)
+	 */
+	explicit WorkQueue(const wq_config_t &wq_config, bool pooled = false);
 	WorkQueue() = delete;
 
 	~WorkQueue();
@@ -69,6 +72,35 @@ public:
 
 	void Run();
 
+	/**
+	 * Process all queued work once, called by the work queue pool for pooled queues.
+	 */
+	void RunPooled();
+
+	/**
+	 * True if this queue is run by the shared work queue pool instead of a dedicated thread.
+	 */
+	bool pooled() const
+	{
+#if defined(CONFIG_PX4_WORK_QUEUE_POOL)
+		return _pooled;
+#else
+		return false;
+#endif // CONFIG_PX4_WORK_QUEUE_POOL
+	}
+
+	bool has_work_items();
+
+	/**
+	 * Call a function for every attached WorkItem, see WorkQueueManagerForEachItem().
+	 */
+	void for_each_item(void (*cb)(const WorkQueue &wq, const WorkItem &item, void *arg), void *arg);
+
+	/**
+	 * Restrict the work queue thread to the cores in cpu_mask (0: no restriction).
+	 */
+	int set_affinity(uint32_t cpu_mask);
+
 	void request_stop() { _should_exit.store(true); }
 
 	void print_status(bool last = false);
@@ -82,6 +114,9 @@ private:
 
 	inline void SignalWorkerThread();
 
+	// process queued work, must be called with the work lock held
+	inline void ProcessQueue();
+
 #ifdef __PX4_NUTTX
 	// In NuttX work can be enqueued from an ISR
 	void work_lock() { _flags = enter_critical_section(); }
@@ -100,6 +135,16 @@ private:
 	const wq_config_t		&_config;
 	BlockingList<WorkItem *>	_work_items;
 	px4::atomic_bool		_should_exit{false};
+	px4::atomic_int			_last_cpu{-1}; // core the queue last ran on (Linux only)
+
+#if defined(__PX4_POSIX)
+	pthread_t			_thread{};
+#endif // __PX4_POSIX
+
+#if defined(CONFIG_PX4_WORK_QUEUE_POOL)
+	const bool			_pooled;
+	bool				_pool_scheduled{false}; // protected by the work lock
+#endif // CONFIG_PX4_WORK_QUEUE_POOL
 
 #if defined(ENABLE_LOCKSTEP_SCHEDULER)
 	int _lockstep_component {-1};
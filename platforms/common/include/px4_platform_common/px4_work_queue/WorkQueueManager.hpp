@@ -39,11 +39,14 @@ namespace px4
 {
 
 class WorkQueue; // forward declaration
+class WorkItem; // forward declaration
 
 struct wq_config_t {
 	const char *name;
 	uint16_t stacksize;
 	int8_t relative_priority; // relative to max
+	bool pooled{false}; // may be run by the shared work queue pool instead of a dedicated thread (CONFIG_PX4_WORK_QUEUE_POOL)
+	uint32_t cpu_affinity{0}; // default CPU mask of the work queue thread (POSIX only), 0: no pinning
 };
 
 namespace wq_configurations
@@ -65,14 +68,14 @@ static constexpr wq_config_t I2C3{"wq:I2C3", 2336, -11};
 static constexpr wq_config_t I2C4{"wq:I2C4", 2336, -12};
 
 // PX4 att/pos controllers, highest priority after sensors.
-static constexpr wq_config_t nav_and_controllers{"wq:nav_and_controllers", 2240, -13};
+static constexpr wq_config_t nav_and_controllers{"wq:nav_and_controllers", 2240, -13, true};
 
 static constexpr wq_config_t INS0{"wq:INS0", 6000, -14};
 static constexpr wq_config_t INS1{"wq:INS1", 6000, -15};
 static constexpr wq_config_t INS2{"wq:INS2", 6000, -16};
 static constexpr wq_config_t INS3{"wq:INS3", 6000, -17};
 
-static constexpr wq_config_t hp_default{"wq:hp_default", 2800, -18};
+static constexpr wq_config_t hp_default{"wq:hp_default", 2800, -18, true};
 
 static constexpr wq_config_t uavcan{"wq:uavcan", 3624, -19};
 
@@ -89,7 +92,7 @@ static constexpr wq_config_t ttyS9{"wq:ttyS9", 1728, -30};
 static constexpr wq_config_t ttyACM0{"wq:ttyACM0", 1728, -31};
 static constexpr wq_config_t ttyUnknown{"wq:ttyUnknown", 1728, -32};
 
-static constexpr wq_config_t lp_default{"wq:lp_default", 3500, -50};
+static constexpr wq_config_t lp_default{"wq:lp_default", 3500, -50, true};
 
 static constexpr wq_config_t test1{"wq:test1", 2000, 0};
 static constexpr wq_config_t test2{"wq:test2", 2000, 0};
@@ -111,6 +114,27 @@ int WorkQueueManagerStop();
  */
 int WorkQueueManagerStatus();
 
+/**
+ * Call a function for every WorkItem of all running work queues (eg. to publish statistics).
+ * The work queue lists are locked during the call, the callback must not block or (de)schedule work.
+ *
+ * @param cb		The function to call.
+ * @param arg		Argument passed to the function.
+ * @return		PX4_OK, or PX4_ERROR if the work queue manager isn't running.
+ */
+int WorkQueueManagerForEachItem(void (*cb)(const WorkQueue &wq, const WorkItem &item, void *arg), void *arg);
+
+/**
+ * Set the CPU affinity of a work queue or module task by name (eg. "wq:rate_ctrl").
+ * The mask is applied to running threads and remembered for threads started later,
+ * overriding the cpu_affinity of the work queue configuration.
+ *
+ * @param name		The work queue or task name.
+ * @param cpu_mask	Bitmask of allowed cores, 0 to remove the restriction.
+ * @return		PX4_OK on success, < 0 on error.
+ */
+int WorkQueueSetAffinity(const char *name, uint32_t cpu_mask);
+
 /**
  * Create (or find) a work queue with a particular configuration.
  *
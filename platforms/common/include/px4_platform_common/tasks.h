@@ -43,6 +43,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #if defined(__PX4_NUTTX)
 typedef int px4_task_t;
@@ -182,6 +183,21 @@ __EXPORT bool px4_task_is_running(const char *taskname);
 #ifdef __PX4_POSIX
 /** set process (and thread) options */
 __EXPORT int px4_prctl(int option, const char *arg2, px4_task_t pid);
+
+/**
+ * Set the CPU affinity (bitmask of allowed cores, 0: no restriction) for all tasks and
+ * work queue threads with the given name. It applies to running tasks and to tasks
+ * spawned later (eg. set in the startup script before the module is started).
+ * @return 0 on success, -ENOTSUP if not supported by the platform, the error of the first
+ *         running task that rejected the mask otherwise (the mask is then not remembered)
+ */
+__EXPORT int px4_task_set_affinity(const char *name, uint32_t cpu_mask);
+
+/** get the CPU affinity configured for a task or work queue name, 0 if none */
+__EXPORT uint32_t px4_task_get_affinity(const char *name);
+
+/** restrict a thread to the cores in cpu_mask */
+__EXPORT int px4_thread_set_affinity(pthread_t thread, uint32_t cpu_mask);
 #endif
 
 /** return the name of the current task */
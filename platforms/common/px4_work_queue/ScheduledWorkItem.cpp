@@ -75,8 +75,14 @@ void ScheduledWorkItem::ScheduleClear()
 void ScheduledWorkItem::print_run_status()
 {
 	if (_call.period > 0) {
+#if defined(CONFIG_PX4_WORK_QUEUE_LATENCY)
+		PX4_INFO_RAW("%-29s %8.1f Hz %12.0f us %10.1f us %10" PRIu32 " us %8" PRIu32 " us %8" PRIu32 " us (%" PRId64 " us)\n",
+			     _item_name, (double)average_rate(), (double)average_interval(), (double)average_latency(),
+			     _latency_histogram.max(), _latency_histogram.percentile(50), _latency_histogram.percentile(99), _call.period);
+#else
 		PX4_INFO_RAW("%-29s %8.1f Hz %12.0f us (%" PRId64 " us)\n", _item_name, (double)average_rate(),
 			     (double)average_interval(), _call.period);
+#endif // CONFIG_PX4_WORK_QUEUE_LATENCY
 
 	} else {
 		WorkItem::print_run_status();
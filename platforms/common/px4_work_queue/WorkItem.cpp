@@ -75,6 +75,10 @@ bool WorkItem::Init(const wq_config_t &config)
 	if ((wq != nullptr) && wq->Attach(this)) {
 		_wq = wq;
 		_time_first_run = 0;
+#if defined(CONFIG_PX4_WORK_QUEUE_LATENCY)
+		_latency_sum = 0;
+		_latency_histogram.reset();
+#endif // CONFIG_PX4_WORK_QUEUE_LATENCY
 		return true;
 	}
 
@@ -132,11 +136,28 @@ float WorkItem::average_interval() const
 	return 0.f;
 }
 
+#if defined(CONFIG_PX4_WORK_QUEUE_LATENCY)
+float WorkItem::average_latency() const
+{
+	if (_latency_histogram.count() > 0) {
+		return (float)_latency_sum / _latency_histogram.count();
+	}
+
+	return 0.f;
+}
+#endif // CONFIG_PX4_WORK_QUEUE_LATENCY
+
 void WorkItem::print_run_status()
 {
+#if defined(CONFIG_PX4_WORK_QUEUE_LATENCY)
+	PX4_INFO_RAW("%-29s %8.1f Hz %12.0f us %10.1f us %10" PRIu32 " us %8" PRIu32 " us %8" PRIu32 " us\n", _item_name,
+		     (double)average_rate(), (double)average_interval(), (double)average_latency(),
+		     _latency_histogram.max(), _latency_histogram.percentile(50), _latency_histogram.percentile(99));
+#else
 	PX4_INFO_RAW("%-29s %8.1f Hz %12.0f us\n", _item_name, (double)average_rate(), (double)average_interval());
+#endif // CONFIG_PX4_WORK_QUEUE_LATENCY
 
-	// reset statistics
+	// reset statistics (the rate only, the scheduling latency is accumulated since the item was initialized)
 	_run_count = 0;
 }
 
@@ -34,6 +34,7 @@
 #include <px4_platform_common/px4_work_queue/WorkQueue.hpp>
 #include <px4_platform_common/px4_work_queue/WorkItem.hpp>
 
+#include <errno.h>
 #include <string.h>
 
 #include <px4_platform_common/log.h>
@@ -41,19 +42,44 @@
 #include <px4_platform_common/time.h>
 #include <drivers/drv_hrt.h>
 
+#if defined(CONFIG_PX4_WORK_QUEUE_POOL)
+#include "WorkQueuePool.hpp"
+#endif // CONFIG_PX4_WORK_QUEUE_POOL
+
 namespace px4
 {
 
-WorkQueue::WorkQueue(const wq_config_t &config) :
+WorkQueue::WorkQueue(const wq_config_t &config, bool pooled) :
 	_config(config)
+#if defined(CONFIG_PX4_WORK_QUEUE_POOL)
+	, _pooled(pooled)
+#endif // CONFIG_PX4_WORK_QUEUE_POOL
 {
-	// set the threads name
+	// set the threads name (pooled work queues are created by the manager and have no thread of their own)
+	if (!pooled()) {
 #ifdef __PX4_DARWIN
-	pthread_setname_np(_config.name);
+		pthread_setname_np(_config.name);
 #else
-	pthread_setname_np(pthread_self(), _config.name);
+		pthread_setname_np(pthread_self(), _config.name);
 #endif
 
+#if defined(__PX4_POSIX)
+		_thread = pthread_self();
+
+		// a mask set by name (eg. from the startup script) overrides the configuration
+		uint32_t cpu_mask = px4_task_get_affinity(_config.name);
+
+		if (cpu_mask == 0) {
+			cpu_mask = _config.cpu_affinity;
+		}
+
+		if (cpu_mask != 0) {
+			px4_thread_set_affinity(_thread, cpu_mask);
+		}
+
+#endif // __PX4_POSIX
+	}
+
 #ifndef __PX4_NUTTX
 	px4_sem_init(&_qlock, 0, 1);
 #endif /* __PX4_NUTTX */
@@ -105,7 +131,8 @@ void WorkQueue::Detach(WorkItem *item)
 
 	_work_items.remove(item);
 
-	if (_work_items.size() == 0) {
+	// pooled work queues stay available without any WorkItems, they don't own a thread
+	if ((_work_items.size() == 0) && !pooled()) {
 		// shutdown, no active WorkItems
 		PX4_DEBUG("stopping: %s, last active WorkItem closing", _config.name);
 
@@ -138,7 +165,33 @@ void WorkQueue::Add(WorkItem *item)
 
 #endif // ENABLE_LOCKSTEP_SCHEDULER
 
+#if defined(CONFIG_PX4_WORK_QUEUE_LATENCY)
+
+	// only the first schedule counts for the latency if the item is already queued
+	if (item->_time_scheduled == 0) {
+		item->_time_scheduled = hrt_absolute_time();
+	}
+
+#endif // CONFIG_PX4_WORK_QUEUE_LATENCY
+
 	_q.push(item);
+
+#if defined(CONFIG_PX4_WORK_QUEUE_POOL)
+
+	if (pooled()) {
+		const bool schedule = !_pool_scheduled;
+		_pool_scheduled = true;
+		work_unlock();
+
+		if (schedule) {
+			WorkQueuePoolSchedule(this);
+		}
+
+		return;
+	}
+
+#endif // CONFIG_PX4_WORK_QUEUE_POOL
+
 	work_unlock();
 
 	SignalWorkerThread();
@@ -157,6 +210,9 @@ void WorkQueue::Remove(WorkItem *item)
 {
 	work_lock();
 	_q.remove(item);
+#if defined(CONFIG_PX4_WORK_QUEUE_LATENCY)
+	item->_time_scheduled = 0;
+#endif // CONFIG_PX4_WORK_QUEUE_LATENCY
 	work_unlock();
 }
 
@@ -165,12 +221,59 @@ void WorkQueue::Clear()
 	work_lock();
 
 	while (!_q.empty()) {
+#if defined(CONFIG_PX4_WORK_QUEUE_LATENCY)
+		_q.pop()->_time_scheduled = 0;
+#else
 		_q.pop();
+#endif // CONFIG_PX4_WORK_QUEUE_LATENCY
 	}
 
 	work_unlock();
 }
 
+void WorkQueue::ProcessQueue()
+{
+#if defined(__PX4_LINUX)
+	_last_cpu.store(sched_getcpu());
+#endif // __PX4_LINUX
+
+	// process queued work
+	while (!_q.empty()) {
+		WorkItem *work = _q.pop();
+
+		hrt_abstime time_scheduled = 0;
+#if defined(CONFIG_PX4_WORK_QUEUE_LATENCY)
+		// taken with the lock held, the item may be scheduled again as soon as the queue is unlocked
+		time_scheduled = work->_time_scheduled;
+		work->_time_scheduled = 0;
+#endif // CONFIG_PX4_WORK_QUEUE_LATENCY
+
+		work_unlock(); // unlock work queue to run (item may requeue itself)
+		work->RunPreamble(time_scheduled);
+		work->Run();
+		// Note: after Run() we cannot access work anymore, as it might have been deleted
+		work_lock(); // re-lock
+
+#if defined(CONFIG_PX4_WORK_QUEUE_POOL)
+
+		if (pooled() && !_q.empty() && WorkQueuePoolShouldYield(_config.relative_priority)) {
+			// let the pool thread run the higher priority queue first, see RunPooled()
+			break;
+		}
+
+#endif // CONFIG_PX4_WORK_QUEUE_POOL
+	}
+
+#if defined(ENABLE_LOCKSTEP_SCHEDULER)
+
+	if (_q.empty()) {
+		px4_lockstep_unregister_component(_lockstep_component);
+		_lockstep_component = -1;
+	}
+
+#endif // ENABLE_LOCKSTEP_SCHEDULER
+}
+
 void WorkQueue::Run()
 {
 	while (!should_exit()) {
@@ -178,37 +281,75 @@ void WorkQueue::Run()
 		do {} while (px4_sem_wait(&_process_lock) != 0);
 
 		work_lock();
+		ProcessQueue();
+		work_unlock();
+	}
 
-		// process queued work
-		while (!_q.empty()) {
-			WorkItem *work = _q.pop();
+	PX4_DEBUG("%s: exiting", _config.name);
+}
 
-			work_unlock(); // unlock work queue to run (item may requeue itself)
-			work->RunPreamble();
-			work->Run();
-			// Note: after Run() we cannot access work anymore, as it might have been deleted
-			work_lock(); // re-lock
-		}
+void WorkQueue::RunPooled()
+{
+#if defined(CONFIG_PX4_WORK_QUEUE_POOL)
+	work_lock();
+	ProcessQueue();
 
-#if defined(ENABLE_LOCKSTEP_SCHEDULER)
+	if (_q.empty()) {
+		// cleared with the lock held, any later Add() schedules the queue again
+		_pool_scheduled = false;
+		work_unlock();
 
-		if (_q.empty()) {
-			px4_lockstep_unregister_component(_lockstep_component);
-			_lockstep_component = -1;
-		}
+	} else {
+		// yielded to a higher priority queue, continue with the remaining work later
+		work_unlock();
+		WorkQueuePoolSchedule(this);
+	}
 
-#endif // ENABLE_LOCKSTEP_SCHEDULER
+#endif // CONFIG_PX4_WORK_QUEUE_POOL
+}
 
-		work_unlock();
+bool WorkQueue::has_work_items()
+{
+	return _work_items.size() > 0;
+}
+
+void WorkQueue::for_each_item(void (*cb)(const WorkQueue &wq, const WorkItem &item, void *arg), void *arg)
+{
+	LockGuard lg{_work_items.mutex()};
+
+	for (WorkItem *item : _work_items) {
+		cb(*this, *item, arg);
 	}
+}
 
-	PX4_DEBUG("%s: exiting", _config.name);
+int WorkQueue::set_affinity(uint32_t cpu_mask)
+{
+#if defined(__PX4_POSIX)
+
+	if (pooled()) {
+		// pooled work queues run on whichever pool thread is free
+		PX4_WARN("%s is pooled, affinity not supported", _config.name);
+		return -EINVAL;
+	}
+
+	return px4_thread_set_affinity(_thread, cpu_mask);
+#else
+	return -ENOTSUP;
+#endif // __PX4_POSIX
 }
 
 void WorkQueue::print_status(bool last)
 {
 	const size_t num_items = _work_items.size();
-	PX4_INFO_RAW("%-16s\n", get_name());
+	const int last_cpu = _last_cpu.load();
+
+	if (last_cpu >= 0) {
+		PX4_INFO_RAW("%-16s (cpu %d)%s\n", get_name(), last_cpu, pooled() ? " (pooled)" : "");
+
+	} else {
+		PX4_INFO_RAW("%-16s%s\n", get_name(), pooled() ? " (pooled)" : "");
+	}
+
 	unsigned i = 0;
 
 	for (WorkItem *item : _work_items) {
@@ -49,6 +49,10 @@
 #include <limits.h>
 #include <string.h>
 
+#if defined(CONFIG_PX4_WORK_QUEUE_POOL)
+#include "WorkQueuePool.hpp"
+#endif // CONFIG_PX4_WORK_QUEUE_POOL
+
 using namespace time_literals;
 
 namespace px4
@@ -259,12 +263,33 @@ WorkQueueManagerRun(int, char **)
 {
 	_wq_manager_wqs_list = new BlockingList<WorkQueue *>();
 	_wq_manager_create_queue = new BlockingQueue<const wq_config_t *, 1>();
+
+#if defined(CONFIG_PX4_WORK_QUEUE_POOL)
+	const bool pool_running = (WorkQueuePoolStart() == PX4_OK);
+
+	if (!pool_running) {
+		PX4_ERR("work queue pool start failed, using dedicated threads");
+	}
+
+#endif // CONFIG_PX4_WORK_QUEUE_POOL
+
 	_wq_manager_running.store(true);
 
 	while (!_wq_manager_should_exit.load()) {
 		// create new work queues as needed
 		const wq_config_t *wq = _wq_manager_create_queue->pop();
 
+#if defined(CONFIG_PX4_WORK_QUEUE_POOL)
+
+		if ((wq != nullptr) && wq->pooled && pool_running) {
+			// pooled work queues don't get a thread, they are run by the work queue pool
+			_wq_manager_wqs_list->add(new WorkQueue(*wq, true));
+			PX4_DEBUG("starting: %s (pooled)", wq->name);
+			continue;
+		}
+
+#endif // CONFIG_PX4_WORK_QUEUE_POOL
+
 		if (wq != nullptr) {
 			// create new work queue
 
@@ -415,9 +440,24 @@ WorkQueueManagerStop()
 
 		// error can't shutdown until all WorkItems are removed/stopped
 		if (_wq_manager_running.load() && (_wq_manager_wqs_list->size() > 0)) {
-			PX4_ERR("can't shutdown with active WQs");
-			WorkQueueManagerStatus();
-			return PX4_ERROR;
+			bool active_wqs = false;
+
+			{
+				LockGuard lg{_wq_manager_wqs_list->mutex()};
+
+				for (WorkQueue *wq : *_wq_manager_wqs_list) {
+					// idle pooled work queues remain in the list
+					if (!wq->pooled() || wq->has_work_items()) {
+						active_wqs = true;
+					}
+				}
+			}
+
+			if (active_wqs) {
+				PX4_ERR("can't shutdown with active WQs");
+				WorkQueueManagerStatus();
+				return PX4_ERROR;
+			}
 		}
 
 		// first ask all WQs to stop
@@ -432,6 +472,34 @@ WorkQueueManagerStop()
 				}
 			}
 
+#if defined(CONFIG_PX4_WORK_QUEUE_POOL)
+			WorkQueuePoolStop();
+
+			// pooled work queues have no thread removing them from the list
+			while (true) {
+				WorkQueue *pooled_wq = nullptr;
+
+				{
+					LockGuard lg{_wq_manager_wqs_list->mutex()};
+
+					for (WorkQueue *wq : *_wq_manager_wqs_list) {
+						if (wq->pooled()) {
+							pooled_wq = wq;
+							break;
+						}
+					}
+				}
+
+				if (pooled_wq == nullptr) {
+					break;
+				}
+
+				_wq_manager_wqs_list->remove(pooled_wq);
+				delete pooled_wq;
+			}
+
+#endif // CONFIG_PX4_WORK_QUEUE_POOL
+
 			// wait until they're all stopped (empty list)
 			while (_wq_manager_wqs_list->size() > 0) {
 				px4_usleep(1000);
@@ -461,13 +529,62 @@ WorkQueueManagerStop()
 	return PX4_OK;
 }
 
+int
+WorkQueueManagerForEachItem(void (*cb)(const WorkQueue &wq, const WorkItem &item, void *arg), void *arg)
+{
+	if (!_wq_manager_should_exit.load() && _wq_manager_running.load()) {
+		LockGuard lg{_wq_manager_wqs_list->mutex()};
+
+		for (WorkQueue *wq : *_wq_manager_wqs_list) {
+			wq->for_each_item(cb, arg);
+		}
+
+		return PX4_OK;
+	}
+
+	return PX4_ERROR;
+}
+
+int
+WorkQueueSetAffinity(const char *name, uint32_t cpu_mask)
+{
+#if defined(__PX4_POSIX)
+	int ret = PX4_OK;
+
+	if (!_wq_manager_should_exit.load() && _wq_manager_running.load()) {
+		LockGuard lg{_wq_manager_wqs_list->mutex()};
+
+		// apply to a running work queue first, a mask it rejects (eg. pooled) must not be remembered
+		for (WorkQueue *wq : *_wq_manager_wqs_list) {
+			if (strcmp(wq->get_name(), name) == 0) {
+				ret = wq->set_affinity(cpu_mask);
+			}
+		}
+	}
+
+	if (ret != PX4_OK) {
+		return ret;
+	}
+
+	// remember the mask for threads started later and apply it to running module tasks
+	return px4_task_set_affinity(name, cpu_mask);
+#else
+	return -ENOTSUP;
+#endif // __PX4_POSIX
+}
+
 int
 WorkQueueManagerStatus()
 {
 	if (!_wq_manager_should_exit.load() && _wq_manager_running.load()) {
 
 		const size_t num_wqs = _wq_manager_wqs_list->size();
+#if defined(CONFIG_PX4_WORK_QUEUE_LATENCY)
+		PX4_INFO_RAW("\nWork Queue: %-2zu threads                          RATE        INTERVAL   LATENCY AVG   LATENCY MAX     LAT P50     LAT P99\n",
+			     num_wqs);
+#else
 		PX4_INFO_RAW("\nWork Queue: %-2zu threads                          RATE        INTERVAL\n", num_wqs);
+#endif // CONFIG_PX4_WORK_QUEUE_LATENCY
 
 		LockGuard lg{_wq_manager_wqs_list->mutex()};
 		size_t i = 0;
@@ -487,6 +604,10 @@ WorkQueueManagerStatus()
 			wq->print_status(last_wq);
 		}
 
+#if defined(CONFIG_PX4_WORK_QUEUE_POOL)
+		WorkQueuePoolStatus();
+#endif // CONFIG_PX4_WORK_QUEUE_POOL
+
 	} else {
 		PX4_INFO("not running");
 	}
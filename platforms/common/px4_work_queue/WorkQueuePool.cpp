@@ -0,0 +1,345 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2025 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "WorkQueuePool.hpp"
+
+#include <px4_platform_common/px4_work_queue/WorkQueue.hpp>
+
+#include <containers/LockGuard.hpp>
+#include <px4_platform_common/atomic.h>
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/posix.h>
+#include <px4_platform_common/sem.h>
+#include <px4_platform_common/tasks.h>
+#include <lib/mathlib/mathlib.h>
+
+#include <inttypes.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace px4
+{
+
+static constexpr int POOL_MAX_THREADS = 16;
+
+// every pooled work queue is queued at most once, so this only needs to hold all pooled queues
+static constexpr int POOL_DEQUE_SIZE = 16;
+
+// larger than every pooled work queue configuration
+static constexpr size_t POOL_STACK_SIZE = 8192;
+
+struct PoolWorker {
+	pthread_t thread{};
+	pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+	// work queues are pushed at the tail, and taken in priority order (the oldest one of equal priority first)
+	WorkQueue *deque[POOL_DEQUE_SIZE] {};
+	unsigned head{0};
+	unsigned tail{0};
+
+	int index{0};
+	int sched_priority{0};
+
+	px4::atomic<uint32_t> runs{0};
+	px4::atomic<uint32_t> steals{0};
+};
+
+static PoolWorker _pool_workers[POOL_MAX_THREADS];
+static int _pool_num_workers{0};
+
+static px4_sem_t _pool_pending;
+static px4::atomic_bool _pool_should_exit{false};
+static px4::atomic<unsigned> _pool_next_worker{0};
+static px4::atomic_int _pool_idle_workers{0};
+static px4::atomic_int _pool_queued{0}; ///< number of work queues in all deques
+
+// index of the pool worker owning the current thread, -1 outside of the pool
+static thread_local int _pool_worker_index{-1};
+
+static bool push_tail(PoolWorker &worker, WorkQueue *wq)
+{
+	LockGuard lg{worker.mutex};
+
+	if (worker.tail - worker.head >= POOL_DEQUE_SIZE) {
+		return false;
+	}
+
+	worker.deque[worker.tail % POOL_DEQUE_SIZE] = wq;
+	worker.tail++;
+	_pool_queued.fetch_add(1);
+	return true;
+}
+
+// position of the highest priority work queue in the deque, the oldest one of equal priority (worker.mutex held)
+static bool highest_priority(const PoolWorker &worker, unsigned &position, int &priority)
+{
+	bool found = false;
+
+	for (unsigned i = worker.head; i != worker.tail; i++) {
+		const int relative_priority = worker.deque[i % POOL_DEQUE_SIZE]->get_config().relative_priority;
+
+		if (!found || relative_priority > priority) {
+			position = i;
+			priority = relative_priority;
+			found = true;
+		}
+	}
+
+	return found;
+}
+
+// take the work queue at position out of the deque, keeping the order of the others (worker.mutex held)
+static WorkQueue *take(PoolWorker &worker, unsigned position)
+{
+	WorkQueue *wq = worker.deque[position % POOL_DEQUE_SIZE];
+
+	for (unsigned i = position; i + 1 != worker.tail; i++) {
+		worker.deque[i % POOL_DEQUE_SIZE] = worker.deque[(i + 1) % POOL_DEQUE_SIZE];
+	}
+
+	worker.tail--;
+	_pool_queued.fetch_sub(1);
+	return wq;
+}
+
+static WorkQueue *next_work_queue(PoolWorker &self)
+{
+	// the highest priority work queue of all the deques, the own deque wins a tie
+	while (_pool_queued.load() > 0) {
+		int best_worker = -1;
+		int best_priority = 0;
+
+		for (int i = 0; i < _pool_num_workers; i++) {
+			PoolWorker &worker = _pool_workers[(self.index + i) % _pool_num_workers];
+			LockGuard lg{worker.mutex};
+			unsigned position;
+			int priority;
+
+			if (highest_priority(worker, position, priority) && (best_worker < 0 || priority > best_priority)) {
+				best_worker = worker.index;
+				best_priority = priority;
+			}
+		}
+
+		if (best_worker < 0) {
+			return nullptr;
+		}
+
+		PoolWorker &worker = _pool_workers[best_worker];
+		LockGuard lg{worker.mutex};
+		unsigned position;
+		int priority;
+
+		// the deque might have changed in the meantime, take its best one or look again
+		if (highest_priority(worker, position, priority)) {
+			if (best_worker != self.index) {
+				self.steals.fetch_add(1);
+			}
+
+			return take(worker, position);
+		}
+	}
+
+	return nullptr;
+}
+
+static void *WorkQueuePoolRunner(void *context)
+{
+	PoolWorker &self = *static_cast<PoolWorker *>(context);
+	_pool_worker_index = self.index;
+
+	char name[16];
+	snprintf(name, sizeof(name), "wq:pool%d", self.index);
+	pthread_setname_np(pthread_self(), name);
+
+	while (!_pool_should_exit.load()) {
+		// loop as the wait may be interrupted by a signal
+		_pool_idle_workers.fetch_add(1);
+
+		do {} while (px4_sem_wait(&_pool_pending) != 0);
+
+		_pool_idle_workers.fetch_sub(1);
+
+		WorkQueue *wq = nullptr;
+
+		while ((wq = next_work_queue(self)) != nullptr) {
+			// run every queue at the priority of its configuration
+			const int sched_priority = sched_get_priority_max(SCHED_FIFO) + wq->get_config().relative_priority;
+
+			if (sched_priority != self.sched_priority) {
+				sched_param param{};
+				param.sched_priority = sched_priority;
+
+				if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0) {
+					self.sched_priority = sched_priority;
+				}
+			}
+
+			wq->RunPooled();
+			self.runs.fetch_add(1);
+		}
+	}
+
+	return nullptr;
+}
+
+int WorkQueuePoolStart()
+{
+#if defined(CONFIG_PX4_WORK_QUEUE_POOL_THREADS) && (CONFIG_PX4_WORK_QUEUE_POOL_THREADS > 0)
+	int num_workers = CONFIG_PX4_WORK_QUEUE_POOL_THREADS;
+#else
+	int num_workers = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+	num_workers = math::constrain(num_workers, 1, POOL_MAX_THREADS);
+
+	px4_sem_init(&_pool_pending, 0, 0);
+	px4_sem_setprotocol(&_pool_pending, SEM_PRIO_NONE);
+
+	_pool_should_exit.store(false);
+
+	// the stack size has to be a multiple of the page size
+	const unsigned int page_size = sysconf(_SC_PAGESIZE);
+	const size_t stacksize_adj = math::max((size_t)PTHREAD_STACK_MIN, (size_t)PX4_STACK_ADJUSTED(POOL_STACK_SIZE));
+	const size_t stacksize = (stacksize_adj + page_size - (stacksize_adj % page_size));
+
+	for (int i = 0; i < num_workers; i++) {
+		PoolWorker &worker = _pool_workers[i];
+		worker.index = i;
+		worker.head = 0;
+		worker.tail = 0;
+		worker.sched_priority = 0;
+
+		pthread_attr_t attr;
+		pthread_attr_init(&attr);
+
+		int ret_setstacksize = pthread_attr_setstacksize(&attr, stacksize);
+
+		if (ret_setstacksize != 0) {
+			PX4_ERR("setting stack size for pool thread %d failed (%i)", i, ret_setstacksize);
+		}
+
+		int ret_create = pthread_create(&worker.thread, &attr, WorkQueuePoolRunner, &worker);
+		pthread_attr_destroy(&attr);
+
+		if (ret_create != 0) {
+			PX4_ERR("failed to create pool thread %d (%i): %s", i, ret_create, strerror(ret_create));
+			break;
+		}
+
+		_pool_num_workers = i + 1;
+	}
+
+	return (_pool_num_workers > 0) ? PX4_OK : PX4_ERROR;
+}
+
+void WorkQueuePoolStop()
+{
+	_pool_should_exit.store(true);
+
+	for (int i = 0; i < _pool_num_workers; i++) {
+		px4_sem_post(&_pool_pending);
+	}
+
+	for (int i = 0; i < _pool_num_workers; i++) {
+		pthread_join(_pool_workers[i].thread, nullptr);
+	}
+
+	_pool_num_workers = 0;
+	px4_sem_destroy(&_pool_pending);
+}
+
+void WorkQueuePoolSchedule(WorkQueue *wq)
+{
+	if (_pool_num_workers <= 0) {
+		PX4_ERR("%s: pool not running", wq->get_name());
+		return;
+	}
+
+	// prefer the local deque when scheduled from within the pool (eg a WorkItem publishing)
+	int index = _pool_worker_index;
+
+	if (index < 0) {
+		index = _pool_next_worker.fetch_add(1) % _pool_num_workers;
+	}
+
+	for (int i = 0; i < _pool_num_workers; i++) {
+		if (push_tail(_pool_workers[(index + i) % _pool_num_workers], wq)) {
+			px4_sem_post(&_pool_pending);
+			return;
+		}
+	}
+
+	PX4_ERR("%s: pool deques full", wq->get_name());
+}
+
+bool WorkQueuePoolShouldYield(int relative_priority)
+{
+	// an idle pool thread picks up the other work queue anyway
+	if (_pool_queued.load() == 0 || _pool_idle_workers.load() > 0) {
+		return false;
+	}
+
+	for (int i = 0; i < _pool_num_workers; i++) {
+		PoolWorker &worker = _pool_workers[i];
+		LockGuard lg{worker.mutex};
+		unsigned position;
+		int priority;
+
+		if (highest_priority(worker, position, priority) && priority > relative_priority) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void WorkQueuePoolStatus()
+{
+	PX4_INFO_RAW("\nWork Queue Pool: %d threads\n", _pool_num_workers);
+
+	for (int i = 0; i < _pool_num_workers; i++) {
+		PoolWorker &worker = _pool_workers[i];
+		PX4_INFO_RAW("    wq:pool%-2d runs: %8" PRIu32 " steals: %8" PRIu32 " priority: %d\n", i, worker.runs.load(),
+			     worker.steals.load(), worker.sched_priority);
+
+		worker.runs.store(0);
+		worker.steals.store(0);
+	}
+}
+
+} // namespace px4
@@ -0,0 +1,81 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2025 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file WorkQueuePool.hpp
+ *
+ * Shared work stealing thread pool for pooled work queues (POSIX only).
+ *
+ * A pooled WorkQueue has no thread of its own. Whenever work is added to an
+ * idle pooled queue the queue is pushed onto the deque of a pool thread. Pool
+ * threads always take the highest priority queue of all deques (their own one
+ * wins a tie), and a running queue yields between WorkItems to a higher priority
+ * queue if no pool thread is idle. A queue is only ever run by one pool thread
+ * at a time, so the WorkItems of a queue are still serialized.
+ */
+
+#pragma once
+
+namespace px4
+{
+
+class WorkQueue; // forward declaration
+
+/**
+ * Start the pool threads.
+ */
+int WorkQueuePoolStart();
+
+/**
+ * Stop and join all pool threads.
+ */
+void WorkQueuePoolStop();
+
+/**
+ * Queue a pooled work queue for processing by the pool.
+ * Must only be called once until the queue was run (see WorkQueue::RunPooled()).
+ */
+void WorkQueuePoolSchedule(WorkQueue *wq);
+
+/**
+ * Called by a pooled work queue between WorkItems.
+ * @return true if a queue with a higher priority is waiting and no pool thread is idle to run it
+ */
+bool WorkQueuePoolShouldYield(int relative_priority);
+
+/**
+ * Print per thread pool statistics.
+ */
+void WorkQueuePoolStatus();
+
+} // namespace px4
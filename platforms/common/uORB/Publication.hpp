@@ -113,6 +113,30 @@ public:
 
 		return (Manager::orb_publish(get_topic(), _handle, &data) == PX4_OK);
 	}
+
+	/**
+	 * Loan the next message slot of the topic to fill it in place instead of
+	 * copying a complete struct with publish(). The topic is locked until
+	 * commit() is called, so fill the message promptly.
+	 *
+	 * @return pointer to the message, nullptr if loans are not supported (use publish()).
+	 */
+	T *loan()
+	{
+		if (!advertised()) {
+			advertise();
+		}
+
+		return static_cast<T *>(Manager::orb_loan(_handle));
+	}
+
+	/**
+	 * Publish the message returned by loan()
+	 */
+	bool commit()
+	{
+		return (Manager::orb_commit(_handle) == PX4_OK);
+	}
 };
 
 /**
@@ -163,6 +163,31 @@ public:
 		return false;
 	}
 
+	/**
+	 * Borrow the next message in place instead of copying it. The message may
+	 * be overwritten by a publisher at any time, so the data is only consistent
+	 * if release() returns true after it was read.
+	 * Requires a topic queue length of at least 2.
+	 *
+	 * @return pointer to the message, nullptr if borrowing is not possible (use copy()).
+	 */
+	const void *borrow()
+	{
+		if (subscribe()) {
+			return Manager::orb_data_borrow(_node, _last_generation);
+		}
+
+		return nullptr;
+	}
+
+	/**
+	 * Check if the message returned by the last borrow() was intact while it was read.
+	 */
+	bool release() const
+	{
+		return (_node != nullptr) && Manager::orb_data_borrow_valid(_node, _last_generation);
+	}
+
 	/**
 	 * Change subscription instance
 	 * @param instance The new multi-Subscription instance
@@ -0,0 +1,253 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2025 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file SubscriptionSynchronizer.hpp
+ *
+ * Schedule a WorkItem once a set of topics has all been updated (wait-for-all) or a timeout passed.
+ */
+
+#pragma once
+
+#include <uORB/SubscriptionCallback.hpp>
+#include <drivers/drv_hrt.h>
+#include <px4_platform_common/atomic.h>
+
+namespace uORB
+{
+
+class SubscriptionCallbackSynchronized;
+
+/**
+ * Collects the updates of up to MAX_SUBSCRIPTIONS SubscriptionCallbackSynchronized and
+ * schedules the WorkItem once all of them have published since the last trigger. If the
+ * set isn't complete within the timeout after the first update, the WorkItem is scheduled
+ * anyway (timed_out() returns true in that case) so a missing publisher can't stall it.
+ * Topics that did not publish within the last STALE_TIMEOUTS timeouts are not waited for,
+ * so the WorkItem runs immediately on the updates of the remaining ones.
+ */
+class SubscriptionSynchronizer
+{
+public:
+	static constexpr int MAX_SUBSCRIPTIONS = 8;
+	static constexpr uint32_t STALE_TIMEOUTS = 10;
+
+	/**
+	 * Constructor
+	 *
+	 * @param work_item The WorkItem that will be scheduled, can be nullptr if call() is overridden.
+	 * @param timeout_us Maximum time to wait for the remaining topics after the first update, see setTimeout().
+	 */
+	SubscriptionSynchronizer(px4::WorkItem *work_item, uint32_t timeout_us) :
+		_work_item(work_item),
+		_timeout_us(timeout_us)
+	{
+	}
+
+	virtual ~SubscriptionSynchronizer()
+	{
+		// the subscriptions are members declared after the synchronizer and already destroyed
+		hrt_cancel(&_timeout_call);
+	}
+
+	// no copy, assignment, move, move assignment
+	SubscriptionSynchronizer(const SubscriptionSynchronizer &) = delete;
+	SubscriptionSynchronizer &operator=(const SubscriptionSynchronizer &) = delete;
+	SubscriptionSynchronizer(SubscriptionSynchronizer &&) = delete;
+	SubscriptionSynchronizer &operator=(SubscriptionSynchronizer &&) = delete;
+
+	/**
+	 * Register the callbacks of all synchronized subscriptions.
+	 * @return true if all callbacks are registered
+	 */
+	inline bool registerCallbacks();
+
+	inline void unregisterCallbacks();
+
+	/**
+	 * Set the maximum time to wait for the remaining topics after the first update, eg. a fraction
+	 * of the measured publication interval.
+	 */
+	void setTimeout(uint32_t timeout_us) { _timeout_us.store(timeout_us); }
+
+	/**
+	 * True if the last trigger was caused by the timeout instead of a complete set of updates.
+	 */
+	bool timed_out() const { return _timed_out.load(); }
+
+	/**
+	 * Called once all topics were updated or the timeout passed, schedules the WorkItem by default.
+	 */
+	virtual void call()
+	{
+		if (_work_item != nullptr) {
+			_work_item->ScheduleNow();
+		}
+	}
+
+private:
+	friend class SubscriptionCallbackSynchronized;
+
+	int add(SubscriptionCallbackSynchronized *sub)
+	{
+		if (_num_subscriptions < MAX_SUBSCRIPTIONS) {
+			_subscriptions[_num_subscriptions] = sub;
+			return _num_subscriptions++;
+		}
+
+		return -1;
+	}
+
+	/**
+	 * Mask of the topics that published recently (wrap around safe 32 bit timestamps).
+	 */
+	uint32_t required_mask(uint32_t now) const
+	{
+		const uint32_t stale_us = STALE_TIMEOUTS * _timeout_us.load();
+		uint32_t mask = 0;
+
+		for (int i = 0; i < _num_subscriptions; i++) {
+			const uint32_t last_update = _last_update[i].load();
+
+			if ((last_update != 0) && (now - last_update < stale_us)) {
+				mask |= (1u << i);
+			}
+		}
+
+		return mask;
+	}
+
+	void updated(int index)
+	{
+		const uint32_t now = (uint32_t)hrt_absolute_time() | 1; // never 0, which means not updated
+		_last_update[index].store(now);
+
+		const uint32_t bit = 1u << index;
+		const uint32_t required = required_mask(now);
+		const uint32_t received = _received.fetch_or(bit) | bit;
+
+		if ((received == bit) && (required != bit)) {
+			// first update of a new set, start waiting for the others
+			hrt_call_after(&_timeout_call, _timeout_us.load(), &SubscriptionSynchronizer::timeout_trampoline, this);
+		}
+
+		if ((received & required) == required) {
+			uint32_t expected = received;
+
+			// only one publisher (or the timeout) may complete the set
+			if (_received.compare_exchange(&expected, 0)) {
+				hrt_cancel(&_timeout_call);
+				_timed_out.store(false);
+				call();
+			}
+		}
+	}
+
+	static void timeout_trampoline(void *arg)
+	{
+		SubscriptionSynchronizer *sync = static_cast<SubscriptionSynchronizer *>(arg);
+
+		if (sync->_received.fetch_and(0) != 0) {
+			sync->_timed_out.store(true);
+			sync->call();
+		}
+	}
+
+	px4::WorkItem *_work_item;
+	px4::atomic<uint32_t> _timeout_us;
+
+	SubscriptionCallbackSynchronized *_subscriptions[MAX_SUBSCRIPTIONS] {};
+	px4::atomic<uint32_t> _last_update[MAX_SUBSCRIPTIONS] {}; ///< lower 32 bits of the last update time, 0 if never updated
+	int _num_subscriptions{0};
+
+	px4::atomic<uint32_t> _received{0};
+	px4::atomic_bool _timed_out{false};
+
+	struct hrt_call _timeout_call {};
+};
+
+// Subscription with callback that reports updates to a SubscriptionSynchronizer
+class SubscriptionCallbackSynchronized : public SubscriptionCallback
+{
+public:
+	/**
+	 * Constructor
+	 *
+	 * @param synchronizer The SubscriptionSynchronizer this topic belongs to (must be declared before).
+	 * @param meta The uORB metadata (usually from the ORB_ID() macro) for the topic.
+	 * @param instance The instance for multi sub.
+	 */
+	SubscriptionCallbackSynchronized(SubscriptionSynchronizer *synchronizer, const orb_metadata *meta,
+					 uint8_t instance = 0) :
+		SubscriptionCallback(meta, 0, instance),	// interval 0
+		_synchronizer(synchronizer),
+		_index(synchronizer->add(this))
+	{
+	}
+
+	virtual ~SubscriptionCallbackSynchronized() = default;
+
+	void call() override
+	{
+		if ((_index >= 0) && updated()) {
+			_synchronizer->updated(_index);
+		}
+	}
+
+private:
+	SubscriptionSynchronizer *_synchronizer;
+	const int _index;
+};
+
+bool SubscriptionSynchronizer::registerCallbacks()
+{
+	bool registered = (_num_subscriptions > 0);
+
+	for (int i = 0; i < _num_subscriptions; i++) {
+		registered = _subscriptions[i]->registerCallback() && registered;
+	}
+
+	return registered;
+}
+
+void SubscriptionSynchronizer::unregisterCallbacks()
+{
+	for (int i = 0; i < _num_subscriptions; i++) {
+		_subscriptions[i]->unregisterCallback();
+	}
+
+	hrt_cancel(&_timeout_call);
+	_received.store(0);
+}
+
+} // namespace uORB
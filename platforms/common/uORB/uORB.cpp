@@ -113,6 +113,37 @@ int uorb_top(char **topic_filter, int num_filters)
 	return OK;
 }
 
+int uorb_shm(const char *topic_name, uint8_t instance)
+{
+#if defined(CONFIG_ORB_SHM)
+
+	if (g_dev == nullptr) {
+		PX4_INFO("uorb is not running");
+		return PX4_ERROR;
+	}
+
+	const orb_metadata *const *topics = orb_get_topics();
+
+	for (size_t i = 0; i < orb_topics_count(); i++) {
+		if (strcmp(topics[i]->o_name, topic_name) == 0) {
+			const int ret = g_dev->attachSharedMemory(topics[i], instance);
+
+			if (ret != PX4_OK) {
+				PX4_ERR("%s: shared memory failed (%i)", topic_name, ret);
+			}
+
+			return ret;
+		}
+	}
+
+	PX4_ERR("topic %s not found", topic_name);
+	return -ENOENT;
+#else
+	PX4_ERR("not supported (CONFIG_ORB_SHM)");
+	return -ENOTSUP;
+#endif /* CONFIG_ORB_SHM */
+}
+
 orb_advert_t orb_advertise(const struct orb_metadata *meta, const void *data)
 {
 	return uORB::Manager::get_instance()->orb_advertise(meta, data);
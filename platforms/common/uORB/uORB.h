@@ -121,6 +121,7 @@ __BEGIN_DECLS
 int uorb_start(void);
 int uorb_status(void);
 int uorb_top(char **topic_filter, int num_filters);
+int uorb_shm(const char *topic_name, uint8_t instance);
 
 /**
  * ORB topic advertiser handle.
@@ -36,9 +36,13 @@
 #include "uORBManager.hpp"
 #include "uORBUtils.hpp"
 
+#include "Publication.hpp"
+
 #include <px4_platform_common/sem.hpp>
 #include <systemlib/px4_macros.h>
+#include <uORB/topics/orb_topic_statistics.h>
 
+#include <inttypes.h>
 #include <math.h>
 
 #ifndef __PX4_QURT // QuRT has no poll()
@@ -52,6 +56,10 @@ uORB::DeviceMaster::DeviceMaster()
 
 uORB::DeviceMaster::~DeviceMaster()
 {
+	for (auto &instances : _node_index) {
+		delete[] instances;
+	}
+
 	px4_sem_destroy(&_lock);
 }
 
@@ -149,8 +157,7 @@ int uORB::DeviceMaster::advertise(const struct orb_metadata *meta, bool is_adver
 			}
 
 			// add to the node map.
-			_node_list.add(node);
-			_node_exists[node->get_instance()].set((orb_id_size_t)node->id(), true);
+			ret = addDeviceNodeLocked(node);
 		}
 
 		group_tries++;
@@ -258,6 +265,12 @@ int uORB::DeviceMaster::addNewDeviceNodes(DeviceNodeStatisticsData **first_node,
 
 		// Pass in 0 to get the index of the latest published data
 		last_node->last_pub_msg_count = last_node->node->updates_available(0);
+
+#if defined(CONFIG_ORB_PROFILING)
+		// discard what was accumulated before the node is monitored
+		DeviceNode::ProfilingData profiling;
+		last_node->node->get_and_reset_profiling_data(profiling);
+#endif /* CONFIG_ORB_PROFILING */
 	}
 
 	return 0;
@@ -269,6 +282,27 @@ void uORB::DeviceMaster::showTop(char **topic_filter, int num_filters)
 {
 	bool print_active_only = true;
 	bool only_once = false; // if true, run only once, then exit
+	bool publish = false;
+	const char *csv_path = nullptr;
+
+	if (topic_filter && num_filters > 0) {
+		// the profiling options are removed first, the remaining arguments keep their meaning
+		int num_remaining = 0;
+
+		for (int i = 0; i < num_filters; ++i) {
+			if (!strcmp("-p", topic_filter[i])) {
+				publish = true;
+
+			} else if (!strcmp("-c", topic_filter[i]) && (i + 1 < num_filters)) {
+				csv_path = topic_filter[++i];
+
+			} else {
+				topic_filter[num_remaining++] = topic_filter[i];
+			}
+		}
+
+		num_filters = num_remaining;
+	}
 
 	if (topic_filter && num_filters > 0) {
 		bool show_all = false;
@@ -289,6 +323,22 @@ void uORB::DeviceMaster::showTop(char **topic_filter, int num_filters)
 		}
 	}
 
+	FILE *csv_file = nullptr;
+
+	if (csv_path) {
+		csv_file = fopen(csv_path, "w");
+
+		if (csv_file == nullptr) {
+			PX4_ERR("failed to open %s (%i)", csv_path, errno);
+			return;
+		}
+
+		fprintf(csv_file, "timestamp,topic,instance,subscribers,rate,queue,size,bandwidth,"
+			"copies_per_publication,latency_avg_us,latency_max_us,unread_rate\n");
+	}
+
+	uORB::Publication<orb_topic_statistics_s> statistics_pub{ORB_ID(orb_topic_statistics)};
+
 	PX4_INFO_RAW("\033[2J\n"); //clear screen
 
 	lock();
@@ -296,6 +346,11 @@ void uORB::DeviceMaster::showTop(char **topic_filter, int num_filters)
 	if (_node_list.empty()) {
 		unlock();
 		PX4_INFO("no active topics");
+
+		if (csv_file) {
+			fclose(csv_file);
+		}
+
 		return;
 	}
 
@@ -369,6 +424,15 @@ void uORB::DeviceMaster::showTop(char **topic_filter, int num_filters)
 				cur_node->pub_msg_delta = roundf(num_msgs / dt);
 				cur_node->last_pub_msg_count += num_msgs;
 
+#if defined(CONFIG_ORB_PROFILING)
+				DeviceNode::ProfilingData profiling;
+				cur_node->node->get_and_reset_profiling_data(profiling);
+				cur_node->copies_delta = roundf(profiling.copies / dt);
+				cur_node->unread_delta = roundf(profiling.unread / dt);
+				cur_node->latency_avg_us = profiling.latency_count > 0 ? profiling.latency_sum_us / profiling.latency_count : 0;
+				cur_node->latency_max_us = profiling.latency_max_us;
+#endif /* CONFIG_ORB_PROFILING */
+
 				total_size += cur_node->pub_msg_delta * cur_node->node->get_meta()->o_size;
 				total_msgs += cur_node->pub_msg_delta;
 
@@ -384,21 +448,67 @@ void uORB::DeviceMaster::showTop(char **topic_filter, int num_filters)
 
 			PX4_INFO_RAW(CLEAR_LINE "update: 1s, topics: %i, total publications: %i, %.1f kB/s\n",
 				     num_topics, total_msgs, (double)(total_size / 1000.f));
-			PX4_INFO_RAW(CLEAR_LINE "%-*s INST #SUB RATE #Q SIZE\n", (int)max_topic_name_length - 2, "TOPIC NAME");
+#if defined(CONFIG_ORB_PROFILING)
+			PX4_INFO_RAW(CLEAR_LINE "%-*s INST #SUB RATE #Q SIZE   KB/S CP/PUB LAT AVG LAT MAX UNREAD\n",
+				     (int)max_topic_name_length - 2, "TOPIC NAME");
+#else
+			PX4_INFO_RAW(CLEAR_LINE "%-*s INST #SUB RATE #Q SIZE   KB/S\n", (int)max_topic_name_length - 2, "TOPIC NAME");
+#endif /* CONFIG_ORB_PROFILING */
 			cur_node = first_node;
 
 			while (cur_node) {
 
 				if (!print_active_only || (cur_node->pub_msg_delta > 0 && cur_node->node->subscriber_count() > 0)) {
-					PX4_INFO_RAW(CLEAR_LINE "%-*s %2i %4i %4i %2i %4i \n", (int)max_topic_name_length,
-						     cur_node->node->get_meta()->o_name, (int)cur_node->node->get_instance(),
+					const orb_metadata *meta = cur_node->node->get_meta();
+					const unsigned bandwidth = cur_node->pub_msg_delta * meta->o_size;
+					const float copies_per_publication = cur_node->pub_msg_delta > 0 ?
+									     (float)cur_node->copies_delta / cur_node->pub_msg_delta : 0.f;
+
+#if defined(CONFIG_ORB_PROFILING)
+					PX4_INFO_RAW(CLEAR_LINE "%-*s %2i %4i %4i %2i %4i %6.1f %6.1f %7u %7u %6u\n", (int)max_topic_name_length,
+						     meta->o_name, (int)cur_node->node->get_instance(),
 						     (int)cur_node->node->subscriber_count(), cur_node->pub_msg_delta,
-						     cur_node->node->get_queue_size(), cur_node->node->get_meta()->o_size);
+						     cur_node->node->get_queue_size(), meta->o_size, (double)(bandwidth / 1000.f),
+						     (double)copies_per_publication, cur_node->latency_avg_us, cur_node->latency_max_us,
+						     cur_node->unread_delta);
+#else
+					PX4_INFO_RAW(CLEAR_LINE "%-*s %2i %4i %4i %2i %4i %6.1f\n", (int)max_topic_name_length,
+						     meta->o_name, (int)cur_node->node->get_instance(),
+						     (int)cur_node->node->subscriber_count(), cur_node->pub_msg_delta,
+						     cur_node->node->get_queue_size(), meta->o_size, (double)(bandwidth / 1000.f));
+#endif /* CONFIG_ORB_PROFILING */
+
+					if (csv_file) {
+						fprintf(csv_file, "%" PRIu64 ",%s,%i,%i,%u,%i,%i,%u,%.2f,%u,%u,%u\n", current_time, meta->o_name,
+							(int)cur_node->node->get_instance(), (int)cur_node->node->subscriber_count(),
+							cur_node->pub_msg_delta, cur_node->node->get_queue_size(), meta->o_size, bandwidth,
+							(double)copies_per_publication, cur_node->latency_avg_us, cur_node->latency_max_us,
+							cur_node->unread_delta);
+					}
+
+					if (publish) {
+						orb_topic_statistics_s statistics{};
+						strncpy(statistics.topic_name, meta->o_name, sizeof(statistics.topic_name) - 1);
+						statistics.instance = cur_node->node->get_instance();
+						statistics.subscribers = cur_node->node->subscriber_count();
+						statistics.publication_rate = cur_node->pub_msg_delta;
+						statistics.bandwidth = bandwidth;
+						statistics.copies_per_publication = copies_per_publication;
+						statistics.latency_avg = cur_node->latency_avg_us;
+						statistics.latency_max = cur_node->latency_max_us;
+						statistics.unread_rate = cur_node->unread_delta;
+						statistics.timestamp = hrt_absolute_time();
+						statistics_pub.publish(statistics);
+					}
 				}
 
 				cur_node = cur_node->next;
 			}
 
+			if (csv_file) {
+				fflush(csv_file);
+			}
+
 
 			if (!only_once) {
 				PX4_INFO_RAW("\033[0J"); // clear the rest of the screen
@@ -420,6 +530,10 @@ void uORB::DeviceMaster::showTop(char **topic_filter, int num_filters)
 	}
 
 	//cleanup
+	if (csv_file) {
+		fclose(csv_file);
+	}
+
 	cur_node = first_node;
 
 	while (cur_node) {
@@ -431,6 +545,37 @@ void uORB::DeviceMaster::showTop(char **topic_filter, int num_filters)
 
 #undef CLEAR_LINE
 
+#if defined(CONFIG_ORB_SHM)
+int uORB::DeviceMaster::attachSharedMemory(const struct orb_metadata *meta, uint8_t instance)
+{
+	if (instance >= ORB_MULTI_MAX_INSTANCES) {
+		return -EINVAL;
+	}
+
+	// create the node like a subscriber of this instance would
+	int node_instance = instance;
+	int ret = advertise(meta, false, &node_instance);
+
+	if (ret != PX4_OK) {
+		return ret;
+	}
+
+	uORB::DeviceNode *node = getDeviceNode(meta, instance);
+
+	if (node == nullptr) {
+		return PX4_ERROR;
+	}
+
+	ret = node->attach_shared_memory();
+
+	if (ret != PX4_OK) {
+		return ret;
+	}
+
+	return uORB::SharedMemoryWatcher::add(node);
+}
+#endif /* CONFIG_ORB_SHM */
+
 uORB::DeviceNode *uORB::DeviceMaster::getDeviceNode(const char *nodepath)
 {
 	lock();
@@ -449,11 +594,36 @@ uORB::DeviceNode *uORB::DeviceMaster::getDeviceNode(const char *nodepath)
 
 uORB::DeviceNode *uORB::DeviceMaster::getDeviceNodeLocked(const struct orb_metadata *meta, const uint8_t instance)
 {
-	for (uORB::DeviceNode *node : _node_list) {
-		if ((strcmp(node->get_name(), meta->o_name) == 0) && (node->get_instance() == instance)) {
-			return node;
+	if ((meta->o_id >= ORB_TOPICS_COUNT) || (instance > ORB_MULTI_MAX_INSTANCES - 1)) {
+		return nullptr;
+	}
+
+	uORB::DeviceNode **instances = _node_index[meta->o_id];
+
+	if (instances == nullptr) {
+		return nullptr;
+	}
+
+	return instances[instance];
+}
+
+int uORB::DeviceMaster::addDeviceNodeLocked(uORB::DeviceNode *node)
+{
+	const orb_id_size_t id = (orb_id_size_t)node->id();
+
+	if (_node_index[id] == nullptr) {
+		_node_index[id] = new uORB::DeviceNode *[ORB_MULTI_MAX_INSTANCES] {};
+
+		if (_node_index[id] == nullptr) {
+			return -ENOMEM;
 		}
 	}
 
-	return nullptr;
+	_node_list.add(node);
+
+	// index before setting the exists bit, getDeviceNode() reads the index without the lock
+	_node_index[id][node->get_instance()] = node;
+	_node_exists[node->get_instance()].set(id, true);
+
+	return PX4_OK;
 }
@@ -82,13 +82,9 @@ public:
 			return nullptr;
 		}
 
-		lock();
-		uORB::DeviceNode *node = getDeviceNodeLocked(meta, instance);
-		unlock();
-
-		//We can safely return the node that can be used by any thread, because
-		//a DeviceNode never gets deleted.
-		return node;
+		//No locking required: a node is added to the index before its exists bit is set,
+		//and a DeviceNode never gets deleted, so it can be used by any thread.
+		return _node_index[meta->o_id][instance];
 
 	}
 
@@ -106,11 +102,21 @@ public:
 	 */
 	void printStatistics();
 
+#if defined(CONFIG_ORB_SHM)
+	/**
+	 * Create the node of a topic instance (if needed) and move its message queue into
+	 * shared memory, so other processes can publish and subscribe.
+	 * @return PX4_OK on success, < 0 on error
+	 */
+	int attachSharedMemory(const struct orb_metadata *meta, uint8_t instance);
+#endif /* CONFIG_ORB_SHM */
+
 	/**
 	 * Continuously print statistics, like the unix top command for processes.
 	 * Exited when the user presses the enter key.
 	 * @param topic_filter list of topic filters: if set, each string can be a substring for topics to match.
-	 *        Or it can be '-a', which means to print all topics instead of only ones currently publishing with subscribers.
+	 *        Or it can be '-a', which means to print all topics instead of only ones currently publishing with subscribers,
+	 *        '-1' to print only once, '-p' to publish orb_topic_statistics or '-c <file>' to write the statistics as CSV.
 	 * @param num_filters
 	 */
 	void showTop(char **topic_filter, int num_filters);
@@ -124,6 +130,10 @@ private:
 		DeviceNode *node;
 		unsigned int last_pub_msg_count;
 		unsigned int pub_msg_delta;
+		unsigned int copies_delta;
+		unsigned int unread_delta;
+		unsigned int latency_avg_us;
+		unsigned int latency_max_us;
 		DeviceNodeStatisticsData *next = nullptr;
 	};
 
@@ -133,15 +143,28 @@ private:
 	friend class uORB::Manager;
 
 	/**
-	 * Find a node give its name.
+	 * Find a node given its topic and instance.
 	 * _lock must already be held when calling this.
 	 * @return node if exists, nullptr otherwise
 	 */
 	uORB::DeviceNode *getDeviceNodeLocked(const struct orb_metadata *meta, const uint8_t instance);
 
+	/**
+	 * Add a new node to the list and the index.
+	 * _lock must already be held when calling this.
+	 * @return PX4_OK, or -ENOMEM if the index could not be allocated
+	 */
+	int addDeviceNodeLocked(uORB::DeviceNode *node);
+
 	IntrusiveSortedList<uORB::DeviceNode *> _node_list;
 	AtomicBitset<ORB_TOPICS_COUNT> _node_exists[ORB_MULTI_MAX_INSTANCES];
 
+	/**
+	 * Nodes indexed by ORB_ID and instance, next to the (name sorted) list for O(1) lookups.
+	 * The instance arrays are only allocated for topics that exist, entries are never removed.
+	 */
+	uORB::DeviceNode **_node_index[ORB_TOPICS_COUNT] {};
+
 	px4_sem_t	_lock; /**< lock to protect access to all class members (also for derived classes) */
 
 	void		lock() { do {} while (px4_sem_wait(&_lock) != 0); }
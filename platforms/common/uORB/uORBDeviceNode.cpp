@@ -57,7 +57,19 @@ uORB::DeviceNode::DeviceNode(const struct orb_metadata *meta, const uint8_t inst
 
 uORB::DeviceNode::~DeviceNode()
 {
+#if defined(CONFIG_ORB_SHM)
+
+	if (_shm != nullptr) {
+		free(_local_data);
+		delete _shm;
+
+	} else {
+		free(_data);
+	}
+
+#else
 	free(_data);
+#endif /* CONFIG_ORB_SHM */
 
 	const char *devname = get_devname();
 
@@ -159,12 +171,7 @@ uORB::DeviceNode::write(cdev::file_t *filp, const char *buffer, size_t buflen)
 
 			/* re-check size */
 			if (nullptr == _data) {
-				const size_t data_size = _meta->o_size * _meta->o_queue;
-				_data = (uint8_t *) px4_cache_aligned_alloc(data_size);
-
-				if (_data) {
-					memset(_data, 0, data_size);
-				}
+				allocate_data();
 			}
 
 			unlock();
@@ -187,11 +194,51 @@ uORB::DeviceNode::write(cdev::file_t *filp, const char *buffer, size_t buflen)
 
 	/* Perform an atomic copy. */
 	ATOMIC_ENTER;
+#if defined(CONFIG_ORB_SEQLOCK)
+	// Publishers are serialized by the node lock, subscribers never take it.
+	// The generation is only advanced once the slot is complete.
+	const unsigned generation = generation_counter().load();
+	const unsigned index = generation % _meta->o_queue;
+	unsigned *sequence = slot_sequence(_data, index);
+
+#if defined(CONFIG_ORB_PROFILING)
+	profile_publication(generation);
+#endif /* CONFIG_ORB_PROFILING */
+
+	__atomic_store_n(sequence, 2 * generation + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	memcpy(_data + (_meta->o_size * index), buffer, _meta->o_size);
+
+	__atomic_store_n(sequence, 2 * generation + 2, __ATOMIC_RELEASE);
+
 	/* wrap-around happens after ~49 days, assuming a publisher rate of 1 kHz */
-	unsigned generation = _generation.fetch_add(1);
+	generation_counter().store(generation + 1);
+
+#if defined(CONFIG_ORB_SHM)
+
+	if (_shm != nullptr) {
+		// subscribers in this process are notified below, wake up other processes
+		_shm_notified_generation.store(generation + 1);
+		_shm->notify();
+	}
+
+#endif /* CONFIG_ORB_SHM */
+#else
+	/* wrap-around happens after ~49 days, assuming a publisher rate of 1 kHz */
+#if defined(CONFIG_ORB_PROFILING)
+	profile_publication(generation_counter().load());
+#endif /* CONFIG_ORB_PROFILING */
+
+	const unsigned generation = generation_counter().load();
 
 	memcpy(_data + (_meta->o_size * (generation % _meta->o_queue)), buffer, _meta->o_size);
 
+	// Only advance the generation once the slot is complete (the store is seq_cst, so it also
+	// releases the copy): borrow() hands out the newest slot without taking the node lock.
+	generation_counter().store(generation + 1);
+#endif /* CONFIG_ORB_SEQLOCK */
+
 	// callbacks
 	for (auto item : _callbacks) {
 		item->call();
@@ -208,6 +255,179 @@ uORB::DeviceNode::write(cdev::file_t *filp, const char *buffer, size_t buflen)
 	return _meta->o_size;
 }
 
+void
+uORB::DeviceNode::allocate_data()
+{
+#if defined(CONFIG_ORB_SEQLOCK)
+	// message queue followed by one sequence counter per slot
+	const size_t data_size = slot_sequence_offset(_meta) + sizeof(unsigned) * _meta->o_queue;
+	uint8_t *data = (uint8_t *) px4_cache_aligned_alloc(data_size);
+
+	if (data) {
+		memset(data, 0, data_size);
+		__atomic_store_n(&_data, data, __ATOMIC_RELEASE);
+	}
+
+#else
+	const size_t data_size = _meta->o_size * _meta->o_queue;
+	_data = (uint8_t *) px4_cache_aligned_alloc(data_size);
+
+	if (_data) {
+		memset(_data, 0, data_size);
+	}
+
+#endif /* CONFIG_ORB_SEQLOCK */
+}
+
+#if defined(CONFIG_ORB_SHM)
+int
+uORB::DeviceNode::attach_shared_memory()
+{
+	lock();
+
+	if (_shm != nullptr) {
+		unlock();
+		return PX4_OK;
+	}
+
+	if (_generation.load() != 0) {
+		// subscribers of this process may already hold the local queue
+		unlock();
+		return -EBUSY;
+	}
+
+	SharedMemoryTopic *shm = new SharedMemoryTopic();
+
+	if (shm == nullptr) {
+		unlock();
+		return -ENOMEM;
+	}
+
+	int ret = shm->create(_meta->o_name, _instance, _meta->o_size, _meta->o_queue, _meta->message_hash);
+
+	if (ret != 0) {
+		delete shm;
+		unlock();
+		return ret;
+	}
+
+	_shm = shm;
+	_local_data = _data;
+
+	// readers load the generation first (acquire) and _data afterwards, so a reader that sees the
+	// shared generation always sees the shared queue as well
+	__atomic_store_n(&_data, shm->data(), __ATOMIC_RELEASE);
+	__atomic_store_n(&_generation_counter, shm->generation(), __ATOMIC_RELEASE);
+
+	const unsigned generation = shm->generation()->load();
+	_shm_notified_generation.store(generation);
+
+	if (generation != 0) {
+		// another process already published into the new segment
+		_data_valid = true;
+	}
+
+	unlock();
+
+	return PX4_OK;
+}
+
+void
+uORB::DeviceNode::check_shared_memory()
+{
+	const unsigned generation = generation_counter().load();
+
+	if (generation == _shm_notified_generation.load()) {
+		return;
+	}
+
+	_shm_notified_generation.store(generation);
+
+	ATOMIC_ENTER;
+
+	// callbacks
+	for (auto item : _callbacks) {
+		item->call();
+	}
+
+	_data_valid = true;
+
+	ATOMIC_LEAVE;
+
+	/* notify any poll waiters */
+	poll_notify(POLLIN);
+}
+#endif /* CONFIG_ORB_SHM */
+
+#if !defined(__PX4_NUTTX)
+void *
+uORB::DeviceNode::loan()
+{
+	lock();
+
+	if (nullptr == _data) {
+		allocate_data();
+
+		if (nullptr == _data) {
+			unlock();
+			return nullptr;
+		}
+	}
+
+	// the slot of the next generation is the oldest one in the queue
+	const unsigned generation = generation_counter().load();
+	const unsigned index = generation % _meta->o_queue;
+
+#if defined(CONFIG_ORB_SEQLOCK)
+	__atomic_store_n(slot_sequence(_data, index), 2 * generation + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+#endif /* CONFIG_ORB_SEQLOCK */
+
+	return _data + (_meta->o_size * index);
+}
+
+int
+uORB::DeviceNode::commit()
+{
+	// the node is still locked from loan()
+#if defined(CONFIG_ORB_PROFILING)
+	profile_publication(generation_counter().load());
+#endif /* CONFIG_ORB_PROFILING */
+
+#if defined(CONFIG_ORB_SEQLOCK)
+	const unsigned generation = generation_counter().load();
+	__atomic_store_n(slot_sequence(_data, generation % _meta->o_queue), 2 * generation + 2, __ATOMIC_RELEASE);
+	generation_counter().store(generation + 1);
+
+#if defined(CONFIG_ORB_SHM)
+
+	if (_shm != nullptr) {
+		_shm_notified_generation.store(generation + 1);
+		_shm->notify();
+	}
+
+#endif /* CONFIG_ORB_SHM */
+#else
+	generation_counter().fetch_add(1);
+#endif /* CONFIG_ORB_SEQLOCK */
+
+	// callbacks
+	for (auto item : _callbacks) {
+		item->call();
+	}
+
+	/* Mark at least one data has been published */
+	_data_valid = true;
+
+	unlock();
+
+	/* notify any poll waiters */
+	poll_notify(POLLIN);
+
+	return PX4_OK;
+}
+#endif /* !__PX4_NUTTX */
+
 int
 uORB::DeviceNode::ioctl(cdev::file_t *filp, int cmd, unsigned long arg)
 {
@@ -414,7 +634,7 @@ int16_t uORB::DeviceNode::process_add_subscription()
 	if (_data != nullptr && ch != nullptr) { // _data will not be null if there is a publisher.
 		// Only send the most recent data to initialize the remote end.
 		if (_data_valid) {
-			ch->send_message(_meta->o_name, _meta->o_size, _data + (_meta->o_size * ((_generation.load() - 1) % _meta->o_queue)));
+			ch->send_message(_meta->o_name, _meta->o_size, _data + (_meta->o_size * ((generation_counter().load() - 1) % _meta->o_queue)));
 		}
 	}
 
@@ -456,13 +676,61 @@ unsigned uORB::DeviceNode::get_initial_generation()
 	ATOMIC_ENTER;
 
 	// If there any previous publications allow the subscriber to read them
-	unsigned generation = _generation.load() - (_data_valid ? 1 : 0);
+	unsigned generation = generation_counter().load() - (_data_valid ? 1 : 0);
 
 	ATOMIC_LEAVE;
 
 	return generation;
 }
 
+#if defined(CONFIG_ORB_PROFILING)
+void uORB::DeviceNode::get_and_reset_profiling_data(ProfilingData &data)
+{
+	data.copies = _profile_copies.fetch_and(0);
+	data.latency_count = _profile_latency_count.fetch_and(0);
+	data.latency_sum_us = _profile_latency_sum_us.fetch_and(0);
+	data.latency_max_us = _profile_latency_max_us.fetch_and(0);
+	data.unread = _profile_unread.fetch_and(0);
+}
+
+void uORB::DeviceNode::profile_publication(unsigned generation)
+{
+	_profile_publish_time.store((uint32_t)hrt_absolute_time());
+
+	// the message of generation - o_queue drops out of the queue now
+	const unsigned queue = _meta->o_queue;
+
+	if ((generation >= queue) && ((int)(_profile_read_generation.load() - (generation - queue + 1)) < 0)) {
+		_profile_unread.fetch_add(1);
+	}
+}
+
+void uORB::DeviceNode::profile_copy(bool new_message, unsigned read_generation, unsigned current_generation)
+{
+	_profile_copies.fetch_add(1);
+
+	if (!new_message) {
+		return;
+	}
+
+	unsigned newest = _profile_read_generation.load();
+
+	while (((int)(read_generation + 1 - newest) > 0)
+	       && !_profile_read_generation.compare_exchange(&newest, read_generation + 1)) {}
+
+	// the publication time is only known for the latest message
+	if (read_generation + 1 == current_generation) {
+		const unsigned latency = (uint32_t)hrt_absolute_time() - _profile_publish_time.load();
+		_profile_latency_count.fetch_add(1);
+		_profile_latency_sum_us.fetch_add(latency);
+
+		unsigned latency_max = _profile_latency_max_us.load();
+
+		while ((latency > latency_max) && !_profile_latency_max_us.compare_exchange(&latency_max, latency)) {}
+	}
+}
+#endif /* CONFIG_ORB_PROFILING */
+
 bool
 uORB::DeviceNode::register_callback(uORB::SubscriptionCallback *callback_sub)
 {
@@ -43,6 +43,14 @@
 #include <px4_platform_common/atomic.h>
 #include <px4_platform_common/px4_config.h>
 
+#if defined(CONFIG_ORB_SEQLOCK)
+#include <sched.h>
+#endif /* CONFIG_ORB_SEQLOCK */
+
+#if defined(CONFIG_ORB_SHM)
+#include "uORBSharedMemory.hpp"
+#endif /* CONFIG_ORB_SHM */
+
 namespace uORB
 {
 class DeviceNode;
@@ -195,7 +203,7 @@ public:
 	 * We can get the correct value regardless of wrap-around or not.
 	 * @param generation The generation of subscriber
 	 */
-	unsigned updates_available(unsigned generation) const { return _generation.load() - generation; }
+	unsigned updates_available(unsigned generation) const { return generation_counter().load() - generation; }
 
 	/**
 	 * Return the initial generation to the subscriber
@@ -203,6 +211,21 @@ public:
 	 */
 	unsigned get_initial_generation();
 
+#if defined(CONFIG_ORB_PROFILING)
+	struct ProfilingData {
+		unsigned copies;		/**< subscriber copies, including repeated copies of the same message */
+		unsigned latency_count;		/**< copies of the latest message, for which the latency is measured */
+		unsigned latency_sum_us;
+		unsigned latency_max_us;
+		unsigned unread;		/**< publications that left the queue without being copied */
+	};
+
+	/**
+	 * Get the profiling counters accumulated since the previous call and reset them.
+	 */
+	void get_and_reset_profiling_data(ProfilingData &data);
+#endif /* CONFIG_ORB_PROFILING */
+
 	const orb_metadata *get_meta() const { return _meta; }
 
 	ORB_ID id() const { return static_cast<ORB_ID>(_meta->o_id); }
@@ -224,17 +247,30 @@ public:
 	 */
 	bool copy(void *dst, unsigned &generation)
 	{
+#if defined(CONFIG_ORB_SEQLOCK)
+		return copy_lockless(dst, generation);
+#else
+
 		if ((dst != nullptr) && (_data != nullptr)) {
 			if (_meta->o_queue == 1) {
 				ATOMIC_ENTER;
 				memcpy(dst, _data, _meta->o_size);
-				generation = _generation.load();
+#if defined(CONFIG_ORB_PROFILING)
+				const unsigned current_generation = generation_counter().load();
+				profile_copy(generation != current_generation, current_generation - 1, current_generation);
+				generation = current_generation;
+#else
+				generation = generation_counter().load();
+#endif /* CONFIG_ORB_PROFILING */
 				ATOMIC_LEAVE;
 				return true;
 
 			} else {
 				ATOMIC_ENTER;
-				const unsigned current_generation = _generation.load();
+				const unsigned current_generation = generation_counter().load();
+#if defined(CONFIG_ORB_PROFILING)
+				const bool new_message = (current_generation != generation);
+#endif /* CONFIG_ORB_PROFILING */
 
 				if (current_generation == generation) {
 					/* The subscriber already read the latest message, but nothing new was published yet.
@@ -250,6 +286,9 @@ public:
 				}
 
 				memcpy(dst, _data + (_meta->o_size * (generation % _meta->o_queue)), _meta->o_size);
+#if defined(CONFIG_ORB_PROFILING)
+				profile_copy(new_message, generation, current_generation);
+#endif /* CONFIG_ORB_PROFILING */
 				ATOMIC_LEAVE;
 
 				++generation;
@@ -259,7 +298,82 @@ public:
 		}
 
 		return false;
+#endif /* CONFIG_ORB_SEQLOCK */
+	}
+
+#if !defined(__PX4_NUTTX)
+	/**
+	 * Loan the next queue slot to a publisher so that the message can be
+	 * written in place. The node stays locked until commit() is called.
+	 *
+	 * @return pointer to the queue slot, nullptr if it could not be allocated.
+	 */
+	void *loan();
+
+	/**
+	 * Publish the message written into the slot returned by loan() and
+	 * release the node lock.
+	 */
+	int commit();
+#endif /* !__PX4_NUTTX */
+
+	/**
+	 * Returns a pointer to the next message in the queue without copying it.
+	 * The oldest slot is never handed out as it is the next one to be written,
+	 * and publishers only advance the generation once a slot is complete.
+	 *
+	 * @param generation
+	 *   The generation of the subscriber, advanced past the borrowed message.
+	 * @return
+	 *   Pointer to the message, nullptr if there is no data or the queue is too short.
+	 */
+	const void *borrow(unsigned &generation)
+	{
+		const unsigned current_generation = generation_counter().load();
+
+#if defined(CONFIG_ORB_SEQLOCK)
+		// loaded after the generation, see attach_shared_memory()
+		const uint8_t *data = __atomic_load_n(&_data, __ATOMIC_ACQUIRE);
+#else
+		const uint8_t *data = _data;
+#endif /* CONFIG_ORB_SEQLOCK */
+
+		const uint8_t queue = _meta->o_queue;
+
+		if ((data == nullptr) || (queue < 2)) {
+			return nullptr;
+		}
+
+		unsigned read_generation = generation;
+
+		if (current_generation == read_generation) {
+			--read_generation;
+		}
+
+		if (!is_in_range(current_generation - queue + 1, read_generation, current_generation - 1)) {
+			read_generation = current_generation - queue + 1;
+		}
+
+#if defined(CONFIG_ORB_PROFILING)
+		profile_copy(generation != current_generation, read_generation, current_generation);
+#endif /* CONFIG_ORB_PROFILING */
 
+		generation = read_generation + 1;
+
+		return data + (_meta->o_size * (read_generation % queue));
+	}
+
+	/**
+	 * Check whether a message returned by borrow() is still intact, i.e. no
+	 * publisher started writing its slot. Call this after reading the message.
+	 *
+	 * @param generation
+	 *   The generation returned by borrow().
+	 */
+	bool borrow_valid(unsigned generation) const
+	{
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		return (generation_counter().load() - (generation - 1)) < _meta->o_queue;
 	}
 
 	// add item to list of work items to schedule on node update
@@ -268,6 +382,24 @@ public:
 	// remove item from list of work items
 	void unregister_callback(SubscriptionCallback *callback_sub);
 
+#if defined(CONFIG_ORB_SHM)
+	/**
+	 * Move the message queue of this node into a shared memory segment, so other
+	 * processes can publish and subscribe (see uORBSharedMemory.hpp). Must be called
+	 * before the topic is published in this process.
+	 * @return PX4_OK on success, -EBUSY if already published
+	 */
+	int attach_shared_memory();
+
+	bool shared_memory_attached() const { return _shm != nullptr; }
+
+	/**
+	 * Notify callbacks and poll waiters of publications by other processes.
+	 * Called by the shared memory watcher thread.
+	 */
+	void check_shared_memory();
+#endif /* CONFIG_ORB_SHM */
+
 protected:
 
 	px4_pollevent_t poll_state(cdev::file_t *filp) override;
@@ -277,11 +409,30 @@ protected:
 private:
 	friend uORBTest::UnitTest;
 
+	/**
+	 * Allocate the message queue. Must be called with the node locked.
+	 */
+	void allocate_data();
+
 	const orb_metadata *_meta; /**< object metadata information */
 
 	uint8_t *_data{nullptr};   /**< allocated object buffer */
 	bool _data_valid{false}; /**< At least one valid data */
 	px4::atomic<unsigned>  _generation{0};  /**< object generation count */
+
+#if defined(CONFIG_ORB_SHM)
+	// once attached, the generation count is the one in the shared memory segment
+	px4::atomic<unsigned> &generation_counter() { return *__atomic_load_n(&_generation_counter, __ATOMIC_ACQUIRE); }
+	const px4::atomic<unsigned> &generation_counter() const { return *__atomic_load_n(&_generation_counter, __ATOMIC_ACQUIRE); }
+
+	px4::atomic<unsigned> *_generation_counter{&_generation};
+	SharedMemoryTopic *_shm{nullptr};
+	uint8_t *_local_data{nullptr}; /**< buffer allocated before attaching, kept for concurrent readers */
+	px4::atomic<unsigned> _shm_notified_generation{0}; /**< last generation subscribers were notified of */
+#else
+	px4::atomic<unsigned> &generation_counter() { return _generation; }
+	const px4::atomic<unsigned> &generation_counter() const { return _generation; }
+#endif /* CONFIG_ORB_SHM */
 	List<uORB::SubscriptionCallback *>	_callbacks;
 
 	const uint8_t _instance; /**< orb multi instance identifier */
@@ -289,6 +440,137 @@ private:
 
 	int8_t _subscriber_count{0};
 
+#if defined(CONFIG_ORB_PROFILING)
+	/**
+	 * Account a publication of generation, before it becomes visible to subscribers.
+	 */
+	void profile_publication(unsigned generation);
+
+	/**
+	 * Account a subscriber copy of read_generation.
+	 * @param new_message false if the subscriber already had the latest message
+	 */
+	void profile_copy(bool new_message, unsigned read_generation, unsigned current_generation);
+
+	px4::atomic<uint32_t> _profile_publish_time{0};	/**< lower 32 bits of the latest publication time [us] */
+	px4::atomic<unsigned> _profile_read_generation{0};	/**< newest generation copied by any subscriber + 1 */
+	px4::atomic<unsigned> _profile_copies{0};
+	px4::atomic<unsigned> _profile_latency_count{0};
+	px4::atomic<unsigned> _profile_latency_sum_us{0};
+	px4::atomic<unsigned> _profile_latency_max_us{0};
+	px4::atomic<unsigned> _profile_unread{0};
+#endif /* CONFIG_ORB_PROFILING */
+
+#if defined(CONFIG_ORB_SEQLOCK)
+	/**
+	 * Each queue slot has a sequence counter stored after the message data.
+	 * While generation g is being written to a slot its counter is 2g + 1 (odd),
+	 * once the write is complete it is 2g + 2. Slots that were never written are 0.
+	 */
+	static size_t slot_sequence_offset(const orb_metadata *meta)
+	{
+		const size_t data_size = meta->o_size * meta->o_queue;
+		return (data_size + sizeof(unsigned) - 1) & ~(sizeof(unsigned) - 1);
+	}
+
+	unsigned *slot_sequence(uint8_t *data, unsigned index) const
+	{
+		return reinterpret_cast<unsigned *>(data + slot_sequence_offset(_meta)) + index;
+	}
+
+	/**
+	 * Lock-free copy for multiple subscribers. The slot sequence is sampled
+	 * before and after the memcpy and the copy is only retried if a publisher
+	 * overwrote the slot in the meantime.
+	 * After COPY_LOCKLESS_MAX_RETRIES failed attempts the copy falls back to the
+	 * node lock, so that a reader with a higher priority than a preempted
+	 * publisher on the same core does not spin forever.
+	 * @return false if the slot stayed busy, eg. a publisher of another process
+	 *         died while writing it (dst is not written in that case)
+	 */
+	bool copy_lockless(void *dst, unsigned &generation)
+	{
+		if ((dst == nullptr) || (__atomic_load_n(&_data, __ATOMIC_ACQUIRE) == nullptr)) {
+			return false;
+		}
+
+		for (int i = 0; i < COPY_LOCKLESS_MAX_RETRIES; ++i) {
+			if (try_copy_lockless(dst, generation)) {
+				return true;
+			}
+		}
+
+		// local publishers are blocked while the lock is held, so an attempt can only fail
+		// while a publisher of another process writes the slot: yield without the lock held
+		for (int i = 0; i < COPY_LOCKED_MAX_RETRIES; ++i) {
+			lock();
+			const bool copied = try_copy_lockless(dst, generation);
+			unlock();
+
+			if (copied) {
+				return true;
+			}
+
+			sched_yield();
+		}
+
+		return false;
+	}
+
+	static constexpr int COPY_LOCKLESS_MAX_RETRIES = 16;
+	static constexpr int COPY_LOCKED_MAX_RETRIES = 16;
+
+	/**
+	 * Single copy attempt of copy_lockless().
+	 * @return false if the slot was written during the attempt
+	 */
+	bool try_copy_lockless(void *dst, unsigned &generation)
+	{
+		const uint8_t queue = _meta->o_queue;
+		const unsigned current_generation = generation_counter().load();
+		// loaded after the generation, see attach_shared_memory()
+		uint8_t *data = __atomic_load_n(&_data, __ATOMIC_ACQUIRE);
+		unsigned read_generation = generation;
+
+		if (current_generation == read_generation) {
+			// nothing new was published yet, return the previous message
+			--read_generation;
+		}
+
+		if (!is_in_range(current_generation - queue, read_generation, current_generation - 1)) {
+			// Reader is too far behind: some messages are lost
+			read_generation = current_generation - queue;
+		}
+
+		const unsigned index = read_generation % queue;
+		unsigned *sequence = slot_sequence(data, index);
+		const unsigned sequence_begin = __atomic_load_n(sequence, __ATOMIC_ACQUIRE);
+
+		if ((sequence_begin & 1) != 0) {
+			// publisher is currently writing this slot
+			return false;
+		}
+
+		if ((sequence_begin != 0) && (sequence_begin != 2 * read_generation + 2)) {
+			// slot already holds a newer generation, re-evaluate the range
+			return false;
+		}
+
+		memcpy(dst, data + (_meta->o_size * index), _meta->o_size);
+
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+		if (__atomic_load_n(sequence, __ATOMIC_RELAXED) != sequence_begin) {
+			return false;
+		}
+
+#if defined(CONFIG_ORB_PROFILING)
+		profile_copy(generation != current_generation, read_generation, current_generation);
+#endif /* CONFIG_ORB_PROFILING */
+		generation = read_generation + 1;
+		return true;
+	}
+#endif /* CONFIG_ORB_SEQLOCK */
 
 // Determine the data range
 	static inline bool is_in_range(unsigned left, unsigned value, unsigned right)
@@ -458,6 +458,66 @@ bool uORB::Manager::orb_data_copy(void *node_handle, void *dst, unsigned &genera
 	return static_cast<DeviceNode *>(node_handle)->copy(dst, generation);
 }
 
+void *uORB::Manager::orb_loan(orb_advert_t handle)
+{
+#if !defined(__PX4_NUTTX)
+
+	if (handle == nullptr) {
+		return nullptr;
+	}
+
+#ifdef ORB_USE_PUBLISHER_RULES
+
+	if (handle == _Instance) {
+		return nullptr;
+	}
+
+#endif /* ORB_USE_PUBLISHER_RULES */
+
+#ifdef CONFIG_ORB_COMMUNICATOR
+
+	// loaned messages are not forwarded to remote subscribers
+	if (get_instance()->get_uorb_communicator() != nullptr) {
+		return nullptr;
+	}
+
+#endif /* CONFIG_ORB_COMMUNICATOR */
+
+	return static_cast<DeviceNode *>(handle)->loan();
+#else
+	// the node can only be locked across calls from thread context
+	return nullptr;
+#endif /* !__PX4_NUTTX */
+}
+
+int uORB::Manager::orb_commit(orb_advert_t handle)
+{
+#if !defined(__PX4_NUTTX)
+
+	if (handle == nullptr) {
+		return PX4_ERROR;
+	}
+
+	return static_cast<DeviceNode *>(handle)->commit();
+#else
+	return PX4_ERROR;
+#endif /* !__PX4_NUTTX */
+}
+
+const void *uORB::Manager::orb_data_borrow(void *node_handle, unsigned &generation)
+{
+	if (!is_advertised(node_handle)) {
+		return nullptr;
+	}
+
+	return static_cast<DeviceNode *>(node_handle)->borrow(generation);
+}
+
+bool uORB::Manager::orb_data_borrow_valid(const void *node_handle, unsigned generation)
+{
+	return static_cast<const DeviceNode *>(node_handle)->borrow_valid(generation);
+}
+
 // add item to list of work items to schedule on node update
 bool uORB::Manager::register_callback(void *node_handle, SubscriptionCallback *callback_sub)
 {
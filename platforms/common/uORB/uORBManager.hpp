@@ -442,6 +442,33 @@ public:
 
 	static bool orb_data_copy(void *node_handle, void *dst, unsigned &generation, bool only_if_updated);
 
+	/**
+	 * Loan the next message slot of a topic queue so that the publisher can fill it in place.
+	 * Every successful loan must be followed by orb_commit() on the same handle.
+	 *
+	 * @param handle  The handle returned from orb_advertise.
+	 * @return  Pointer to the message slot or nullptr if loans are not supported for this handle.
+	 */
+	static void *orb_loan(orb_advert_t handle);
+
+	/**
+	 * Publish the message previously written into the slot returned by orb_loan().
+	 *
+	 * @param handle  The handle returned from orb_advertise.
+	 * @return  PX4_OK on success, PX4_ERROR otherwise.
+	 */
+	static int orb_commit(orb_advert_t handle);
+
+	/**
+	 * Get a read-only pointer to the next message of a topic queue without copying it.
+	 * The data is only consistent if orb_data_borrow_valid() returns true after it was read.
+	 *
+	 * @return  Pointer to the message or nullptr if borrowing is not possible for this topic.
+	 */
+	static const void *orb_data_borrow(void *node_handle, unsigned &generation);
+
+	static bool orb_data_borrow_valid(const void *node_handle, unsigned generation);
+
 	static bool register_callback(void *node_handle, SubscriptionCallback *callback_sub);
 
 	static void unregister_callback(void *node_handle, SubscriptionCallback *callback_sub);
@@ -302,6 +302,28 @@ bool uORB::Manager::orb_data_copy(void *node_handle, void *dst, unsigned &genera
 	return data.ret;
 }
 
+// Zero-copy access to the kernel side message queues is not possible from userspace
+
+void *uORB::Manager::orb_loan(orb_advert_t handle)
+{
+	return nullptr;
+}
+
+int uORB::Manager::orb_commit(orb_advert_t handle)
+{
+	return PX4_ERROR;
+}
+
+const void *uORB::Manager::orb_data_borrow(void *node_handle, unsigned &generation)
+{
+	return nullptr;
+}
+
+bool uORB::Manager::orb_data_borrow_valid(const void *node_handle, unsigned generation)
+{
+	return false;
+}
+
 bool uORB::Manager::register_callback(void *node_handle, SubscriptionCallback *callback_sub)
 {
 	orbiocdevregcallback_t data = {node_handle, callback_sub, false};
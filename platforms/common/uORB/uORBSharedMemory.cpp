@@ -0,0 +1,121 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2025 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "uORBSharedMemory.hpp"
+#include "uORBDeviceNode.hpp"
+
+#include <px4_platform_common/log.h>
+
+#include <pthread.h>
+
+namespace uORB
+{
+
+static DeviceNode *_watched_nodes[SharedMemoryWatcher::MAX_NODES] {};
+static px4::atomic_int _num_watched_nodes{0};
+static pthread_mutex_t _watcher_mutex = PTHREAD_MUTEX_INITIALIZER;
+static bool _watcher_running{false};
+
+int SharedMemoryWatcher::add(DeviceNode *node)
+{
+	pthread_mutex_lock(&_watcher_mutex);
+
+	const int num_nodes = _num_watched_nodes.load();
+
+	for (int i = 0; i < num_nodes; i++) {
+		if (_watched_nodes[i] == node) {
+			pthread_mutex_unlock(&_watcher_mutex);
+			return PX4_OK;
+		}
+	}
+
+	if (num_nodes >= MAX_NODES) {
+		pthread_mutex_unlock(&_watcher_mutex);
+		return -ENOSPC;
+	}
+
+	// the node is visible to the thread once the count is incremented
+	_watched_nodes[num_nodes] = node;
+	_num_watched_nodes.store(num_nodes + 1);
+
+	if (!_watcher_running) {
+		pthread_t thread;
+		pthread_attr_t attr;
+		pthread_attr_init(&attr);
+		pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+		const int ret = pthread_create(&thread, &attr, &SharedMemoryWatcher::run, nullptr);
+		pthread_attr_destroy(&attr);
+
+		if (ret != 0) {
+			PX4_ERR("failed to create shared memory watcher (%i)", ret);
+			pthread_mutex_unlock(&_watcher_mutex);
+			return -ret;
+		}
+
+		pthread_setname_np(thread, "uorb_shm");
+		_watcher_running = true;
+	}
+
+	pthread_mutex_unlock(&_watcher_mutex);
+
+	return PX4_OK;
+}
+
+void *SharedMemoryWatcher::run(void *)
+{
+	SharedMemoryDoorbell doorbell;
+
+	if (doorbell.open() != 0) {
+		PX4_ERR("failed to open shared memory doorbell");
+		return nullptr;
+	}
+
+	for (;;) {
+		// sample the doorbell before checking, a publication during the check won't wait
+		const unsigned value = doorbell.value();
+
+		const int num_nodes = _num_watched_nodes.load();
+
+		for (int i = 0; i < num_nodes; i++) {
+			_watched_nodes[i]->check_shared_memory();
+		}
+
+		// the timeout also covers publishers that don't ring the doorbell
+		doorbell.wait(value, 100);
+	}
+
+	return nullptr;
+}
+
+} // namespace uORB
@@ -0,0 +1,500 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2025 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file uORBSharedMemory.hpp
+ *
+ * Shared memory segment of a uORB topic instance, for zero serialization
+ * publish/subscribe between separate Linux processes (CONFIG_ORB_SHM).
+ *
+ * The segment is a header followed by exactly the message queue layout of a
+ * DeviceNode with CONFIG_ORB_SEQLOCK: o_queue message slots, then one sequence
+ * counter per slot. The queue generation in the header is the futex word
+ * subscribers wait on. Besides the generated topic structs, this header only
+ * depends on the header-only px4_platform_common/atomic.h, so it can be used by
+ * other processes (eg. a vision pipeline) directly:
+ *
+ *     uORB::SharedMemoryTopic shm;
+ *     shm.open("vehicle_visual_odometry", 0, sizeof(vehicle_odometry_s), vehicle_odometry_s::ORB_QUEUE_LENGTH, hash);
+ *     shm.publish(&odometry);
+ *
+ * PX4 creates the segments (see DeviceNode::attach_shared_memory()) and removes
+ * them on shutdown, other processes open them once PX4 is running.
+ * Only one process may publish a topic instance at a time.
+ */
+
+#pragma once
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <px4_platform_common/atomic.h>
+
+namespace uORB
+{
+
+struct SharedMemoryHeader {
+	static constexpr uint32_t MAGIC = 0x4f345850; // "PX4O"
+	static constexpr uint32_t VERSION = 1;
+
+	px4::atomic<uint32_t> magic;	///< set last, once the header is initialized
+	uint32_t version;
+	uint32_t message_hash;
+	uint16_t o_size;
+	uint8_t o_queue;
+	uint8_t instance;
+
+	px4::atomic<unsigned> generation;	///< queue generation, futex word for subscribers
+	px4::atomic<unsigned> waiters;		///< number of processes waiting on the generation
+};
+
+// the message queue starts cache line aligned after the header
+static constexpr size_t SHARED_MEMORY_DATA_OFFSET = (sizeof(SharedMemoryHeader) + 63) & ~size_t(63);
+
+/**
+ * Futex helpers, the words are in shared memory so the non private operations are used.
+ */
+static inline int shared_memory_futex_wait(px4::atomic<unsigned> *word, unsigned expected, int timeout_ms)
+{
+	struct timespec timeout;
+	timeout.tv_sec = timeout_ms / 1000;
+	timeout.tv_nsec = (timeout_ms % 1000) * 1000000;
+
+	return syscall(SYS_futex, reinterpret_cast<unsigned *>(word), FUTEX_WAIT, expected, (timeout_ms >= 0) ? &timeout : nullptr,
+		       nullptr, 0);
+}
+
+static inline void shared_memory_futex_wake(px4::atomic<unsigned> *word)
+{
+	syscall(SYS_futex, reinterpret_cast<unsigned *>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+/**
+ * Process wide doorbell, rung by every publisher outside of PX4 so that PX4 can
+ * notify its own subscribers (callbacks and poll) of external publications.
+ */
+class SharedMemoryDoorbell
+{
+public:
+	static constexpr const char *NAME = "/px4_orb_doorbell";
+
+	~SharedMemoryDoorbell() { close(); }
+
+	int open()
+	{
+		if (_counter != nullptr) {
+			return 0;
+		}
+
+		int fd = shm_open(NAME, O_RDWR | O_CREAT, 0660);
+
+		if (fd < 0) {
+			return -errno;
+		}
+
+		// zero filled if newly created, unchanged otherwise
+		if (ftruncate(fd, sizeof(px4::atomic<unsigned>)) != 0) {
+			const int ret = -errno;
+			::close(fd);
+			return ret;
+		}
+
+		void *mem = mmap(nullptr, sizeof(px4::atomic<unsigned>), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		::close(fd);
+
+		if (mem == MAP_FAILED) {
+			return -errno;
+		}
+
+		_counter = static_cast<px4::atomic<unsigned> *>(mem);
+		return 0;
+	}
+
+	void close()
+	{
+		if (_counter != nullptr) {
+			munmap(_counter, sizeof(px4::atomic<unsigned>));
+			_counter = nullptr;
+		}
+	}
+
+	bool is_open() const { return _counter != nullptr; }
+
+	unsigned value() const { return _counter->load(); }
+
+	void ring()
+	{
+		_counter->fetch_add(1);
+		shared_memory_futex_wake(_counter);
+	}
+
+	/**
+	 * Wait until the doorbell changes from value or the timeout passes.
+	 */
+	void wait(unsigned value, int timeout_ms) { shared_memory_futex_wait(_counter, value, timeout_ms); }
+
+private:
+	px4::atomic<unsigned> *_counter{nullptr};
+};
+
+/**
+ * Shared memory segment of one topic instance.
+ */
+class SharedMemoryTopic
+{
+public:
+	SharedMemoryTopic() = default;
+	~SharedMemoryTopic() { close(); }
+
+	// no copy, assignment, move, move assignment
+	SharedMemoryTopic(const SharedMemoryTopic &) = delete;
+	SharedMemoryTopic &operator=(const SharedMemoryTopic &) = delete;
+	SharedMemoryTopic(SharedMemoryTopic &&) = delete;
+	SharedMemoryTopic &operator=(SharedMemoryTopic &&) = delete;
+
+	/**
+	 * Size of the message queue (messages and slot sequence counters), must match DeviceNode.
+	 */
+	static size_t queue_size(uint16_t o_size, uint8_t o_queue)
+	{
+		const size_t data_size = (size_t)o_size * o_queue;
+		const size_t sequence_offset = (data_size + sizeof(unsigned) - 1) & ~(sizeof(unsigned) - 1);
+		return sequence_offset + sizeof(unsigned) * o_queue;
+	}
+
+	/**
+	 * Create the segment of a topic instance, done by PX4 which owns the segment.
+	 * A segment left over from a previous run (eg. after a crash) is removed first,
+	 * so the queue always starts empty. The segment is removed again by close().
+	 * @return 0 on success
+	 */
+	int create(const char *topic_name, uint8_t instance, uint16_t o_size, uint8_t o_queue, uint32_t message_hash)
+	{
+		if (_header != nullptr) {
+			return -EBUSY;
+		}
+
+		segment_name(topic_name, instance);
+		shm_unlink(_name);
+
+		int fd = shm_open(_name, O_RDWR | O_CREAT | O_EXCL, 0660);
+
+		if (fd < 0) {
+			return -errno;
+		}
+
+		_size = SHARED_MEMORY_DATA_OFFSET + queue_size(o_size, o_queue);
+
+		// zero filled: generation and slot sequences start at 0
+		if (ftruncate(fd, _size) != 0) {
+			const int ret = -errno;
+			::close(fd);
+			shm_unlink(_name);
+			return ret;
+		}
+
+		void *mem = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		::close(fd);
+
+		if (mem == MAP_FAILED) {
+			const int ret = -errno;
+			shm_unlink(_name);
+			return ret;
+		}
+
+		_header = static_cast<SharedMemoryHeader *>(mem);
+		_owner = true;
+
+		_header->version = SharedMemoryHeader::VERSION;
+		_header->message_hash = message_hash;
+		_header->o_size = o_size;
+		_header->o_queue = o_queue;
+		_header->instance = instance;
+		_header->magic.store(SharedMemoryHeader::MAGIC);
+
+		return 0;
+	}
+
+	/**
+	 * Open the segment of a topic instance created by PX4. A process must open the
+	 * segment again after PX4 restarted, the previous one is then gone.
+	 * @param external_publisher true if this process publishes outside of PX4 (rings the doorbell)
+	 * @return 0 on success, -ENOENT if PX4 did not create the segment (yet),
+	 *         -EPROTO if the segment doesn't match the message definition
+	 */
+	int open(const char *topic_name, uint8_t instance, uint16_t o_size, uint8_t o_queue, uint32_t message_hash,
+		 bool external_publisher = true)
+	{
+		if (_header != nullptr) {
+			return -EBUSY;
+		}
+
+		segment_name(topic_name, instance);
+
+		int fd = shm_open(_name, O_RDWR, 0660);
+
+		if (fd < 0) {
+			return -errno;
+		}
+
+		_size = SHARED_MEMORY_DATA_OFFSET + queue_size(o_size, o_queue);
+
+		// the creator might still be sizing the segment
+		struct stat st {};
+
+		for (int i = 0; (fstat(fd, &st) == 0) && ((size_t)st.st_size < _size) && (i < 100); i++) {
+			usleep(1000);
+		}
+
+		if ((size_t)st.st_size < _size) {
+			::close(fd);
+			return -EPROTO;
+		}
+
+		void *mem = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		::close(fd);
+
+		if (mem == MAP_FAILED) {
+			return -errno;
+		}
+
+		_header = static_cast<SharedMemoryHeader *>(mem);
+
+		for (int i = 0; (_header->magic.load() != SharedMemoryHeader::MAGIC) && (i < 100); i++) {
+			usleep(1000);
+		}
+
+		if ((_header->magic.load() != SharedMemoryHeader::MAGIC)
+		    || (_header->version != SharedMemoryHeader::VERSION)
+		    || (_header->message_hash != message_hash)
+		    || (_header->o_size != o_size) || (_header->o_queue != o_queue)) {
+			close();
+			return -EPROTO;
+		}
+
+		if (external_publisher) {
+			const int ret = _doorbell.open();
+
+			if (ret != 0) {
+				close();
+				return ret;
+			}
+		}
+
+		return 0;
+	}
+
+	/**
+	 * Unmap the segment, the owner also removes it.
+	 */
+	void close()
+	{
+		_doorbell.close();
+
+		if (_header != nullptr) {
+			munmap(_header, _size);
+			_header = nullptr;
+		}
+
+		if (_owner) {
+			shm_unlink(_name);
+			_owner = false;
+		}
+	}
+
+	bool is_open() const { return _header != nullptr; }
+
+	/** message queue with the DeviceNode (CONFIG_ORB_SEQLOCK) layout */
+	uint8_t *data() const { return reinterpret_cast<uint8_t *>(_header) + SHARED_MEMORY_DATA_OFFSET; }
+
+	px4::atomic<unsigned> *generation() const { return &_header->generation; }
+
+	unsigned updates_available(unsigned generation) const { return _header->generation.load() - generation; }
+
+	/**
+	 * Publish a message, see DeviceNode::write().
+	 */
+	void publish(const void *message)
+	{
+		const unsigned generation = _header->generation.load();
+		const unsigned index = generation % _header->o_queue;
+		unsigned *sequence = slot_sequence(index);
+
+		__atomic_store_n(sequence, 2 * generation + 1, __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+
+		memcpy(data() + (_header->o_size * index), message, _header->o_size);
+
+		__atomic_store_n(sequence, 2 * generation + 2, __ATOMIC_RELEASE);
+		_header->generation.store(generation + 1);
+
+		notify();
+
+		if (_doorbell.is_open()) {
+			_doorbell.ring();
+		}
+	}
+
+	/**
+	 * Wake up the subscribers of other processes waiting in wait().
+	 */
+	void notify()
+	{
+		if (_header->waiters.load() > 0) {
+			shared_memory_futex_wake(&_header->generation);
+		}
+	}
+
+	/**
+	 * Copy the next message after generation, see DeviceNode::copy().
+	 * @return true if a message was copied (generation is updated), false if nothing
+	 *         was published or the slot stayed busy, eg. its publisher died while writing it
+	 */
+	bool copy(void *dst, unsigned &generation) const
+	{
+		const uint8_t queue = _header->o_queue;
+
+		for (int retry = 0; retry < MAX_COPY_RETRIES; ++retry) {
+			const unsigned current_generation = _header->generation.load();
+
+			if (current_generation == 0) {
+				// nothing published yet
+				return false;
+			}
+
+			unsigned read_generation = generation;
+
+			if (current_generation == read_generation) {
+				--read_generation;
+			}
+
+			if ((current_generation - 1 - read_generation) >= queue) {
+				// reader is too far behind (or ahead after a restart): some messages are lost
+				read_generation = current_generation - ((current_generation < queue) ? current_generation : queue);
+			}
+
+			const unsigned index = read_generation % queue;
+			unsigned *sequence = slot_sequence(index);
+			const unsigned sequence_begin = __atomic_load_n(sequence, __ATOMIC_ACQUIRE);
+
+			if (((sequence_begin & 1) != 0) || (sequence_begin != 2 * read_generation + 2)) {
+				// being written or already overwritten by a newer generation
+				continue;
+			}
+
+			memcpy(dst, data() + (_header->o_size * index), _header->o_size);
+
+			__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+			if (__atomic_load_n(sequence, __ATOMIC_RELAXED) == sequence_begin) {
+				generation = read_generation + 1;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	/**
+	 * Block until a message newer than generation was published or the timeout passed.
+	 * @return true if an update is available
+	 */
+	bool wait(unsigned generation, int timeout_ms)
+	{
+		if (_header->generation.load() != generation) {
+			return true;
+		}
+
+		_header->waiters.fetch_add(1);
+		shared_memory_futex_wait(&_header->generation, generation, timeout_ms);
+		_header->waiters.fetch_sub(1);
+
+		return _header->generation.load() != generation;
+	}
+
+private:
+	static constexpr int MAX_COPY_RETRIES = 16;
+
+	void segment_name(const char *topic_name, uint8_t instance)
+	{
+		snprintf(_name, sizeof(_name), "/px4_orb_%s%u", topic_name, (unsigned)instance);
+	}
+
+	unsigned *slot_sequence(unsigned index) const
+	{
+		const size_t data_size = (size_t)_header->o_size * _header->o_queue;
+		const size_t sequence_offset = (data_size + sizeof(unsigned) - 1) & ~(sizeof(unsigned) - 1);
+		return reinterpret_cast<unsigned *>(data() + sequence_offset) + index;
+	}
+
+	SharedMemoryHeader *_header{nullptr};
+	size_t _size{0};
+	char _name[NAME_MAX] {};
+	bool _owner{false};	///< created the segment, removes it on close
+
+	SharedMemoryDoorbell _doorbell;
+};
+
+#if defined(CONFIG_ORB_SHM)
+class DeviceNode;
+
+/**
+ * PX4 side thread notifying the subscribers of shared memory nodes of publications
+ * by other processes (which ring the doorbell).
+ */
+class SharedMemoryWatcher
+{
+public:
+	static constexpr int MAX_NODES = 32;
+
+	/**
+	 * Watch a node with attached shared memory, starts the thread on first use.
+	 */
+	static int add(DeviceNode *node);
+
+private:
+	static void *run(void *);
+};
+#endif /* CONFIG_ORB_SHM */
+
+} // namespace uORB
@@ -40,7 +40,9 @@
 #include <math.h>
 #include <lib/cdev/CDev.hpp>
 #include <uORB/PublicationMulti.hpp>
+#include <uORB/Subscription.hpp>
 #include <uORB/SubscriptionMultiArray.hpp>
+#include <uORB/SubscriptionSynchronizer.hpp>
 
 uORBTest::UnitTest &uORBTest::UnitTest::instance()
 {
@@ -177,6 +179,30 @@ int uORBTest::UnitTest::test()
 		return ret;
 	}
 
+	ret = test_SubscriptionSynchronizer();
+
+	if (ret != OK) {
+		return ret;
+	}
+
+#if defined(CONFIG_ORB_SHM)
+	ret = test_shared_memory();
+
+	if (ret != OK) {
+		return ret;
+	}
+
+#endif /* CONFIG_ORB_SHM */
+
+#if defined(CONFIG_ORB_PROFILING)
+	ret = test_profiling();
+
+	if (ret != OK) {
+		return ret;
+	}
+
+#endif /* CONFIG_ORB_PROFILING */
+
 	ret = test_multi();
 
 	if (ret != OK) {
@@ -207,6 +233,12 @@ int uORBTest::UnitTest::test()
 		return ret;
 	}
 
+	ret = test_borrow_concurrent();
+
+	if (ret != OK) {
+		return ret;
+	}
+
 	ret = test_queue();
 
 	if (ret != OK) {
@@ -725,6 +757,259 @@ int uORBTest::UnitTest::test_wrap_around()
 	return test_note("PASS orb wrap around");
 }
 
+int uORBTest::UnitTest::test_SubscriptionSynchronizer()
+{
+	test_note("Testing SubscriptionSynchronizer");
+
+	class TestSynchronizer : public uORB::SubscriptionSynchronizer
+	{
+	public:
+		TestSynchronizer() : SubscriptionSynchronizer(nullptr, 10000) {} // 10 ms timeout
+		void call() override { calls.fetch_add(1); }
+
+		px4::atomic_int calls{0};
+	};
+
+	TestSynchronizer sync;
+	uORB::SubscriptionCallbackSynchronized sub_a{&sync, ORB_ID(orb_test)};
+	uORB::SubscriptionCallbackSynchronized sub_b{&sync, ORB_ID(orb_test_large)};
+
+	uORB::Publication<orb_test_s> pub_a{ORB_ID(orb_test)};
+	uORB::Publication<orb_test_large_s> pub_b{ORB_ID(orb_test_large)};
+	orb_test_s a{};
+	orb_test_large_s b{};
+
+	if (!sync.registerCallbacks()) {
+		return test_fail("registering callbacks failed");
+	}
+
+	// a topic that did not publish yet is not waited for
+	pub_a.publish(a);
+
+	if ((sync.calls.load() != 1) || sync.timed_out()) {
+		sync.unregisterCallbacks();
+		return test_fail("not triggered immediately without other recent topics (%i)", sync.calls.load());
+	}
+
+	sub_a.update(&a);
+
+	// once both published recently, a single topic must not trigger
+	pub_b.publish(b);
+
+	if (sync.calls.load() != 1) {
+		sync.unregisterCallbacks();
+		return test_fail("triggered before all topics were updated");
+	}
+
+	// repeated updates of the same topic don't complete the set either
+	pub_b.publish(b);
+	pub_a.publish(a);
+
+	if ((sync.calls.load() != 2) || sync.timed_out()) {
+		sync.unregisterCallbacks();
+		return test_fail("not triggered once after all topics were updated (%i)", sync.calls.load());
+	}
+
+	sub_a.update(&a);
+	sub_b.update(&b);
+
+	// incomplete set triggers after the timeout
+	pub_a.publish(a);
+	px4_usleep(50000);
+
+	if ((sync.calls.load() != 3) || !sync.timed_out()) {
+		sync.unregisterCallbacks();
+		return test_fail("not triggered by the timeout (%i)", sync.calls.load());
+	}
+
+	sub_a.update(&a);
+
+	// b is stale after STALE_TIMEOUTS timeouts without update and not waited for anymore
+	px4_usleep(uORB::SubscriptionSynchronizer::STALE_TIMEOUTS * 10000 + 50000);
+	pub_a.publish(a);
+
+	if ((sync.calls.load() != 4) || sync.timed_out()) {
+		sync.unregisterCallbacks();
+		return test_fail("waited for a stale topic (%i)", sync.calls.load());
+	}
+
+	sync.unregisterCallbacks();
+
+	return test_note("PASS SubscriptionSynchronizer");
+}
+
+#if defined(CONFIG_ORB_PROFILING)
+int uORBTest::UnitTest::test_profiling()
+{
+	test_note("Testing profiling counters");
+
+	uORB::Publication<orb_test_large_s> pub{ORB_ID(orb_test_large)};
+	uORB::Subscription sub{ORB_ID(orb_test_large)};
+	orb_test_large_s t{};
+
+	if (!pub.advertise()) {
+		return test_fail("advertise failed");
+	}
+
+	auto node = uORB::Manager::get_instance()->get_device_master()->getDeviceNode(ORB_ID(orb_test_large), 0);
+
+	if (node == nullptr) {
+		return test_fail("node not found");
+	}
+
+	sub.update(&t);
+
+	uORB::DeviceNode::ProfilingData data;
+	node->get_and_reset_profiling_data(data);
+
+	// the first one was never copied when the other two replace it
+	pub.publish(t);
+	pub.publish(t);
+	pub.publish(t);
+
+	// a new message and the same one again
+	sub.update(&t);
+	sub.copy(&t);
+
+	node->get_and_reset_profiling_data(data);
+
+	if (data.unread != 2) {
+		return test_fail("unread publications: %u, expected 2", data.unread);
+	}
+
+	if (data.copies != 2) {
+		return test_fail("copies: %u, expected 2", data.copies);
+	}
+
+	if (data.latency_count != 1) {
+		return test_fail("latency samples: %u, expected 1", data.latency_count);
+	}
+
+	node->get_and_reset_profiling_data(data);
+
+	if (data.copies != 0 || data.unread != 0 || data.latency_max_us != 0) {
+		return test_fail("counters not reset");
+	}
+
+	return test_note("PASS profiling counters");
+}
+#endif /* CONFIG_ORB_PROFILING */
+
+#if defined(CONFIG_ORB_SHM)
+int uORBTest::UnitTest::test_shared_memory()
+{
+	test_note("Testing orb shared memory");
+
+	// a segment left over by a previous run (not removed, as after a crash) must not be seen by the new one
+	const orb_metadata *meta = ORB_ID(orb_test_medium_shm);
+	int fd = shm_open("/px4_orb_orb_test_medium_shm0", O_RDWR | O_CREAT, 0660);
+	const size_t stale_size = uORB::SHARED_MEMORY_DATA_OFFSET + uORB::SharedMemoryTopic::queue_size(meta->o_size,
+				  meta->o_queue);
+
+	if ((fd < 0) || (ftruncate(fd, stale_size) != 0)) {
+		return test_fail("stale segment create failed: %d", errno);
+	}
+
+	void *stale = mmap(nullptr, stale_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (stale == MAP_FAILED) {
+		return test_fail("stale segment map failed: %d", errno);
+	}
+
+	uORB::SharedMemoryHeader *stale_header = static_cast<uORB::SharedMemoryHeader *>(stale);
+	stale_header->version = uORB::SharedMemoryHeader::VERSION;
+	stale_header->message_hash = meta->message_hash;
+	stale_header->o_size = meta->o_size;
+	stale_header->o_queue = meta->o_queue;
+	stale_header->generation.store(5);
+	stale_header->magic.store(uORB::SharedMemoryHeader::MAGIC);
+	munmap(stale, stale_size);
+
+	int ret = uORB::Manager::get_instance()->get_device_master()->attachSharedMemory(ORB_ID(orb_test_medium_shm), 0);
+
+	if (ret != PX4_OK) {
+		return test_fail("attach failed: %i", ret);
+	}
+
+	uORB::DeviceNode *node = uORB::Manager::get_instance()->get_device_master()->getDeviceNode(ORB_ID(
+					 orb_test_medium_shm), 0);
+
+	if ((node == nullptr) || !node->shared_memory_attached()) {
+		return test_fail("node not attached");
+	}
+
+	// the segment as seen by another process
+	uORB::SharedMemoryTopic external;
+	ret = external.open(meta->o_name, 0, meta->o_size, meta->o_queue, meta->message_hash);
+
+	if (ret != 0) {
+		return test_fail("external open failed: %i", ret);
+	}
+
+	orb_test_medium_s u{};
+	unsigned external_generation = 0;
+
+	if (external.copy(&u, external_generation)) {
+		return test_fail("stale segment data seen");
+	}
+
+	// publish in PX4, copy in the other process
+	orb_test_medium_s t{};
+	t.val = 1;
+	orb_advert_t ptopic = orb_advertise(ORB_ID(orb_test_medium_shm), &t);
+
+	if (ptopic == nullptr) {
+		return test_fail("advertise failed: %d", errno);
+	}
+
+	t.val = 2;
+	orb_publish(ORB_ID(orb_test_medium_shm), ptopic, &t);
+
+	for (int i = 1; i <= 2; ++i) {
+		if (!external.copy(&u, external_generation) || (u.val != i)) {
+			return test_fail("external copy mismatch: %d expected %d", u.val, i);
+		}
+	}
+
+	// publish in the other process, copy and borrow in PX4
+	uORB::Subscription sub{ORB_ID(orb_test_medium_shm)};
+	sub.subscribe();
+
+	t.val = 3;
+	external.publish(&t);
+
+	if (!sub.updated()) {
+		return test_fail("external publication not seen");
+	}
+
+	if (!sub.copy(&u) || (u.val != 3)) {
+		return test_fail("copy mismatch: %d expected 3", u.val);
+	}
+
+	t.val = 4;
+	external.publish(&t);
+
+	const orb_test_medium_s *borrowed = static_cast<const orb_test_medium_s *>(sub.borrow());
+
+	if ((borrowed == nullptr) || (borrowed->val != 4) || !sub.release()) {
+		return test_fail("borrow of the external publication failed");
+	}
+
+	orb_unadvertise(ptopic);
+	external.close();
+
+	// only PX4 removes the segment, closing it in another process does not
+	if (external.open(meta->o_name, 0, meta->o_size, meta->o_queue, meta->message_hash) != 0) {
+		return test_fail("external reopen failed");
+	}
+
+	external.close();
+
+	return test_note("PASS orb shared memory");
+}
+#endif /* CONFIG_ORB_SHM */
+
 int uORBTest::UnitTest::test_SubscriptionMulti()
 {
 
@@ -821,6 +1106,104 @@ int uORBTest::UnitTest::test_SubscriptionMulti()
 	return test_note("PASS orb SubscriptionMulti");
 }
 
+int uORBTest::UnitTest::pub_test_borrow_entry(int argc, char *argv[])
+{
+	uORBTest::UnitTest &t = uORBTest::UnitTest::instance();
+	return t.pub_test_borrow_main();
+}
+
+int uORBTest::UnitTest::pub_test_borrow_main()
+{
+	orb_test_loan_medium_s t{};
+	orb_advert_t ptopic = orb_advertise(ORB_ID(orb_test_loan_medium), &t);
+
+	if (ptopic == nullptr) {
+		_thread_should_exit = true;
+		return test_fail("advertise failed: %d", errno);
+	}
+
+	for (int i = 1; i <= 20000; ++i) {
+		// every byte of the message identifies it, so a torn read can be detected
+		t.val = i;
+		memset(t.junk, i & 0xff, sizeof(t.junk));
+		orb_publish(ORB_ID(orb_test_loan_medium), ptopic, &t);
+
+		if ((i % 64) == 0) {
+			px4_usleep(100);
+		}
+	}
+
+	_thread_should_exit = true;
+	orb_unadvertise(ptopic);
+
+	return 0;
+}
+
+int uORBTest::UnitTest::test_borrow_concurrent()
+{
+	test_note("Testing orb borrow (concurrent publisher)");
+
+	uORB::Subscription sub{ORB_ID(orb_test_loan_medium)};
+
+	_thread_should_exit = false;
+
+	char *const args[1] = { nullptr };
+	int pubsub_task = px4_task_spawn_cmd("uorb_test_borrow",
+					     SCHED_DEFAULT,
+					     SCHED_PRIORITY_DEFAULT,
+					     2000,
+					     (px4_main_t)&uORBTest::UnitTest::pub_test_borrow_entry,
+					     args);
+
+	if (pubsub_task < 0) {
+		return test_fail("failed launching task");
+	}
+
+	int num_intact = 0;
+	int num_overwritten = 0;
+	int iteration = 0;
+
+	while (!_thread_should_exit) {
+		if ((++iteration % 64) == 0) {
+			// let the publisher run on single core targets
+			px4_usleep(100);
+		}
+
+		const orb_test_loan_medium_s *msg = static_cast<const orb_test_loan_medium_s *>(sub.borrow());
+
+		if (msg == nullptr) {
+			continue;
+		}
+
+		const int val = msg->val;
+		bool consistent = true;
+
+		for (size_t i = 0; i < sizeof(msg->junk); ++i) {
+			if (msg->junk[i] != (val & 0xff)) {
+				consistent = false;
+				break;
+			}
+		}
+
+		if (sub.release()) {
+			if (!consistent) {
+				return test_fail("borrowed message %i was overwritten, but reported intact", val);
+			}
+
+			++num_intact;
+
+		} else {
+			++num_overwritten;
+		}
+	}
+
+	if (num_intact == 0) {
+		return test_fail("no intact message borrowed");
+	}
+
+	return test_note("PASS orb borrow (concurrent publisher, %i intact, %i overwritten)", num_intact, num_overwritten);
+}
+
 int uORBTest::UnitTest::test_queue()
 {
 	test_note("Testing orb queuing");
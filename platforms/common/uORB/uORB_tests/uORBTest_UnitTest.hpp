@@ -41,6 +41,7 @@
 #include <uORB/topics/orb_test.h>
 #include <uORB/topics/orb_test_medium.h>
 #include <uORB/topics/orb_test_large.h>
+#include <uORB/topics/orb_test_loan_medium.h>
 
 #include <px4_platform_common/defines.h>
 #include <px4_platform_common/posix.h>
@@ -75,7 +76,7 @@ public:
 	// Assist in testing the wrap-around situation
 	static void set_generation(uORB::DeviceNode &node, unsigned generation)
 	{
-		node._generation.store(generation);
+		node.generation_counter().store(generation);
 	}
 
 private:
@@ -108,6 +109,20 @@ private:
 
 	int test_SubscriptionMulti();
 
+	int test_SubscriptionSynchronizer();
+
+#if defined(CONFIG_ORB_SHM)
+	int test_shared_memory();
+#endif /* CONFIG_ORB_SHM */
+
+#if defined(CONFIG_ORB_PROFILING)
+	int test_profiling();
+#endif /* CONFIG_ORB_PROFILING */
+
+	int test_borrow_concurrent();
+	static int pub_test_borrow_entry(int argc, char *argv[]);
+	int pub_test_borrow_main();
+
 	/* queuing tests */
 	int test_queue();
 	static int pub_test_queue_entry(int argc, char *argv[]);
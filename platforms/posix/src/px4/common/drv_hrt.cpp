@@ -61,6 +61,15 @@
 static LockstepScheduler lockstep_scheduler {true};
 #endif
 
+// timerfd expiries are absolute CLOCK_MONOTONIC times, which hrt_absolute_time() only matches without
+// lockstep and the Voxl2 time offset
+#if defined(__PX4_LINUX) && !defined(ENABLE_LOCKSTEP_SCHEDULER) && !defined(CONFIG_MUORB_APPS_SYNC_TIMESTAMP)
+#define HRT_TIMERFD_SUPPORTED
+#include <sys/prctl.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
 // Intervals in usec
 static constexpr unsigned HRT_INTERVAL_MIN = 50;
 static constexpr unsigned HRT_INTERVAL_MAX = 50000000;
@@ -84,6 +93,16 @@ __EXPORT uint32_t latency_counters[LATENCY_BUCKET_COUNT + 1];
 static px4_sem_t 	_hrt_lock;
 static struct work_s	_hrt_work;
 
+#if defined(HRT_TIMERFD_SUPPORTED)
+// Callouts due within this window after the expiry are run in the same wakeup
+static constexpr unsigned HRT_TIMERFD_BATCH_WINDOW = 10;
+
+static int		_hrt_timerfd{-1};
+static px4::atomic_bool	_hrt_timerfd_active{false};
+
+static int hrt_timerfd_thread(int argc, char *argv[]);
+#endif
+
 static void hrt_latency_update();
 
 static void hrt_call_reschedule();
@@ -228,6 +247,10 @@ void	hrt_init()
 	}
 
 	memset(&_hrt_work, 0, sizeof(_hrt_work));
+
+#if defined(CONFIG_HRT_TIMERFD)
+	hrt_set_timerfd_backend(true);
+#endif
 }
 
 static void
@@ -294,6 +317,24 @@ hrt_call_reschedule()
 	struct hrt_call	*next = (struct hrt_call *)sq_peek(&callout_queue);
 	hrt_abstime	deadline = now + HRT_INTERVAL_MAX;
 
+#if defined(HRT_TIMERFD_SUPPORTED)
+
+	if (_hrt_timerfd_active.load()) {
+		// arm the absolute deadline, a deadline in the past expires immediately
+		if ((next != nullptr) && (next->deadline < deadline)) {
+			deadline = next->deadline;
+		}
+
+		latency_baseline = deadline;
+
+		struct itimerspec expiry {};
+		abstime_to_ts(&expiry.it_value, deadline);
+		timerfd_settime(_hrt_timerfd, TFD_TIMER_ABSTIME, &expiry, nullptr);
+		return;
+	}
+
+#endif // HRT_TIMERFD_SUPPORTED
+
 	/*
 	 * Determine what the next deadline will be.
 	 *
@@ -413,6 +454,12 @@ hrt_call_invoke()
 	struct hrt_call	*call;
 	hrt_abstime deadline;
 
+#if defined(HRT_TIMERFD_SUPPORTED)
+	const hrt_abstime batch_window = _hrt_timerfd_active.load() ? HRT_TIMERFD_BATCH_WINDOW : 0;
+#else
+	const hrt_abstime batch_window = 0;
+#endif
+
 	hrt_lock();
 
 	while (true) {
@@ -425,7 +472,7 @@ hrt_call_invoke()
 			break;
 		}
 
-		if (call->deadline > now) {
+		if (call->deadline > now + batch_window) {
 			break;
 		}
 
@@ -466,6 +513,80 @@ hrt_call_invoke()
 	hrt_unlock();
 }
 
+#if defined(HRT_TIMERFD_SUPPORTED)
+static int hrt_timerfd_thread(int argc, char *argv[])
+{
+	// the default timer slack of 50 us would dominate the wakeup jitter
+	prctl(PR_SET_TIMERSLACK, 1UL);
+
+	while (true) {
+		uint64_t expirations = 0;
+
+		// the timer is re-armed by hrt_call_reschedule() whenever the head of the callout queue changes
+		if ((read(_hrt_timerfd, &expirations, sizeof(expirations)) == sizeof(expirations))
+		    && _hrt_timerfd_active.load()) {
+			hrt_tim_isr(nullptr);
+		}
+	}
+
+	return 0;
+}
+#endif // HRT_TIMERFD_SUPPORTED
+
+#if defined(__PX4_LINUX)
+int hrt_set_timerfd_backend(bool timerfd)
+{
+#if defined(HRT_TIMERFD_SUPPORTED)
+	hrt_lock();
+
+	if (timerfd && (_hrt_timerfd < 0)) {
+		_hrt_timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+
+		if (_hrt_timerfd < 0) {
+			const int err = errno;
+			hrt_unlock();
+			PX4_ERR("timerfd_create failed (%i)", err);
+			return -err;
+		}
+
+		if (px4_task_spawn_cmd("hrt_timer", SCHED_DEFAULT, SCHED_PRIORITY_MAX, 2000, hrt_timerfd_thread, nullptr) < 0) {
+			close(_hrt_timerfd);
+			_hrt_timerfd = -1;
+			hrt_unlock();
+			PX4_ERR("hrt_timer task start failed");
+			return PX4_ERROR;
+		}
+	}
+
+	_hrt_timerfd_active.store(timerfd);
+
+	// hand the next expiry over to the selected timer
+	if (timerfd) {
+		hrt_work_cancel(&_hrt_work);
+
+	} else if (_hrt_timerfd >= 0) {
+		struct itimerspec disarm {};
+		timerfd_settime(_hrt_timerfd, 0, &disarm, nullptr);
+	}
+
+	hrt_call_reschedule();
+	hrt_unlock();
+	return PX4_OK;
+#else
+	return timerfd ? -ENOTSUP : PX4_OK;
+#endif // HRT_TIMERFD_SUPPORTED
+}
+
+bool hrt_timerfd_backend()
+{
+#if defined(HRT_TIMERFD_SUPPORTED)
+	return _hrt_timerfd_active.load();
+#else
+	return false;
+#endif // HRT_TIMERFD_SUPPORTED
+}
+#endif // __PX4_LINUX
+
 int px4_clock_gettime(clockid_t clk_id, struct timespec *tp)
 {
 #if defined(ENABLE_LOCKSTEP_SCHEDULER)
@@ -54,6 +54,11 @@
 #include <mach/mach.h>
 #endif
 
+#ifdef __PX4_LINUX
+#include <dirent.h>
+#include <stdlib.h>
+#endif
+
 #ifdef __PX4_QURT
 // dprintf is not available on QURT. Use the usual output to mini-dm.
 #define dprintf(_fd, _text, ...) ((_fd) == 1 ? PX4_INFO((_text), ##__VA_ARGS__) : (void)(_fd))
@@ -92,8 +97,93 @@ void print_load(int fd, struct print_load_s *print_state)
 		memset(clear_line, 0, sizeof(clear_line));
 	}
 
-#if defined(__PX4_LINUX) || defined(__PX4_CYGWIN) || defined(__PX4_QURT)
-	dprintf(fd, "%sTOP NOT IMPLEMENTED ON LINUX, QURT, WINDOWS (ONLY ON NUTTX, APPLE)\n", clear_line);
+#if defined(__PX4_LINUX)
+	// list all threads of the PX4 process, including the core each thread last ran on
+	DIR *task_dir = opendir("/proc/self/task");
+
+	if (task_dir == nullptr) {
+		PX4_WARN("ERROR opening /proc/self/task");
+		return;
+	}
+
+	const long ticks_per_sec = sysconf(_SC_CLK_TCK);
+	int num_threads = 0;
+
+	dprintf(fd, "%s%6s %-20s %5s %4s %10s %3s\n", clear_line, "TID", "COMMAND", "STATE", "PRIO", "TIME (ms)", "CPU");
+
+	struct dirent *entry;
+
+	while ((entry = readdir(task_dir)) != nullptr) {
+		if (entry->d_name[0] == '.') {
+			continue;
+		}
+
+		char path[64];
+		snprintf(path, sizeof(path), "/proc/self/task/%s/stat", entry->d_name);
+
+		FILE *stat_file = fopen(path, "r");
+
+		if (stat_file == nullptr) {
+			continue;
+		}
+
+		char stat_buf[512];
+		const size_t len = fread(stat_buf, 1, sizeof(stat_buf) - 1, stat_file);
+		fclose(stat_file);
+		stat_buf[len] = '\0';
+
+		// the command name is in parentheses and may contain spaces
+		char *name_start = strchr(stat_buf, '(');
+		char *name_end = strrchr(stat_buf, ')');
+
+		if ((name_start == nullptr) || (name_end == nullptr) || (name_end < name_start)) {
+			continue;
+		}
+
+		*name_end = '\0';
+
+		// fields after the command name, starting at field 3 (state)
+		char state = ' ';
+		unsigned long utime = 0;
+		unsigned long stime = 0;
+		long priority = 0;
+		int processor = -1;
+		int field = 3;
+		char *saveptr = nullptr;
+
+		for (char *tok = strtok_r(name_end + 1, " ", &saveptr); tok != nullptr; tok = strtok_r(nullptr, " ", &saveptr)) {
+			switch (field) {
+			case 3: state = tok[0]; break;
+
+			case 14: utime = strtoul(tok, nullptr, 10); break;
+
+			case 15: stime = strtoul(tok, nullptr, 10); break;
+
+			case 18: priority = strtol(tok, nullptr, 10); break;
+
+			case 39: processor = strtol(tok, nullptr, 10); break;
+			}
+
+			if (++field > 39) {
+				break;
+			}
+		}
+
+		const unsigned long time_ms = (ticks_per_sec > 0) ? (utime + stime) * 1000 / ticks_per_sec : 0;
+
+		// the kernel priority of realtime threads is -1 - sched_priority
+		dprintf(fd, "%s%6s %-20s %5c %4ld %10lu %3d\n", clear_line, entry->d_name, name_start + 1, state,
+			(priority < 0) ? (-1 - priority) : priority, time_ms, processor);
+
+		num_threads++;
+	}
+
+	closedir(task_dir);
+
+	dprintf(fd, "%sThreads: %d total\n", clear_line, num_threads);
+
+#elif defined(__PX4_CYGWIN) || defined(__PX4_QURT)
+	dprintf(fd, "%sTOP NOT IMPLEMENTED ON QURT, WINDOWS (ONLY ON NUTTX, LINUX, APPLE)\n", clear_line);
 
 #elif defined(__PX4_DARWIN)
 	pid_t pid = getpid();   //-- this is the process id you need info for
@@ -51,6 +51,7 @@
 #include <pthread.h>
 #include <limits.h>
 
+#include <inttypes.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <string>
@@ -60,6 +61,7 @@
 #include <systemlib/err.h>
 
 #define PX4_MAX_TASKS 50
+#define PX4_MAX_AFFINITY_RULES 16
 
 pthread_t _shell_task_id = 0;
 pthread_mutex_t task_mutex = PTHREAD_MUTEX_INITIALIZER;
@@ -72,6 +74,13 @@ struct task_entry {
 
 static task_entry taskmap[PX4_MAX_TASKS] {};
 
+struct affinity_rule {
+	std::string name{};
+	uint32_t cpu_mask{0};
+};
+
+static affinity_rule affinity_rules[PX4_MAX_AFFINITY_RULES] {};
+
 typedef struct {
 	px4_main_t entry;
 	char name[16]; //pthread_setname_np is restricted to 16 chars
@@ -221,6 +230,8 @@ px4_task_t px4_task_spawn_cmd(const char *name, int scheduler, int priority, int
 		return (rv < 0) ? rv : -rv;
 	}
 
+	const uint32_t cpu_mask = px4_task_get_affinity(name);
+
 	pthread_mutex_lock(&task_mutex);
 
 	px4_task_t taskid = 0;
@@ -268,6 +279,10 @@ px4_task_t px4_task_spawn_cmd(const char *name, int scheduler, int priority, int
 		}
 	}
 
+	if (cpu_mask != 0) {
+		px4_thread_set_affinity(taskmap[taskid].pid, cpu_mask);
+	}
+
 	pthread_attr_destroy(&attr);
 	pthread_mutex_unlock(&task_mutex);
 
@@ -422,6 +437,122 @@ const char *px4_get_taskname()
 	return prog_name;
 }
 
+int px4_thread_set_affinity(pthread_t thread, uint32_t cpu_mask)
+{
+#if defined(__PX4_LINUX)
+	cpu_set_t cpuset;
+	CPU_ZERO(&cpuset);
+
+	for (unsigned cpu = 0; cpu < 32; cpu++) {
+		if (cpu_mask & (1u << cpu)) {
+			CPU_SET(cpu, &cpuset);
+		}
+	}
+
+	if (cpu_mask == 0) {
+		// no restriction
+		const long num_cpus = sysconf(_SC_NPROCESSORS_CONF);
+
+		for (long cpu = 0; cpu < num_cpus && cpu < CPU_SETSIZE; cpu++) {
+			CPU_SET(cpu, &cpuset);
+		}
+	}
+
+	const int rv = pthread_setaffinity_np(thread, sizeof(cpuset), &cpuset);
+
+	if (rv != 0) {
+		PX4_ERR("failed to set cpu affinity 0x%" PRIx32 " (%i): %s", cpu_mask, rv, strerror(rv));
+		return -rv;
+	}
+
+	return 0;
+#else
+	return -ENOTSUP;
+#endif
+}
+
+int px4_task_set_affinity(const char *name, uint32_t cpu_mask)
+{
+#if defined(__PX4_LINUX)
+	pthread_mutex_lock(&task_mutex);
+
+	int free_rule = -1;
+	int rule = -1;
+
+	for (int i = 0; i < PX4_MAX_AFFINITY_RULES; i++) {
+		if (affinity_rules[i].name == name) {
+			rule = i;
+			break;
+		}
+
+		if ((free_rule < 0) && affinity_rules[i].name.empty()) {
+			free_rule = i;
+		}
+	}
+
+	if (rule < 0) {
+		rule = free_rule;
+	}
+
+	if (rule < 0) {
+		pthread_mutex_unlock(&task_mutex);
+		return -ENOSPC;
+	}
+
+	// apply to already running tasks first, a mask one of them rejects is not remembered
+	int ret = 0;
+
+	for (int i = 0; i < PX4_MAX_TASKS; ++i) {
+		if (taskmap[i].isused && (taskmap[i].name == name)) {
+			const int task_ret = px4_thread_set_affinity(taskmap[i].pid, cpu_mask);
+
+			if (task_ret != 0) {
+				PX4_ERR("setting cpu affinity of task %s (%i) failed", name, i);
+
+				if (ret == 0) {
+					ret = task_ret;
+				}
+			}
+		}
+	}
+
+	if (ret == 0) {
+		if (cpu_mask != 0) {
+			affinity_rules[rule].name = name;
+			affinity_rules[rule].cpu_mask = cpu_mask;
+
+		} else {
+			affinity_rules[rule].name.clear();
+			affinity_rules[rule].cpu_mask = 0;
+		}
+	}
+
+	pthread_mutex_unlock(&task_mutex);
+
+	return ret;
+#else
+	return -ENOTSUP;
+#endif
+}
+
+uint32_t px4_task_get_affinity(const char *name)
+{
+	uint32_t cpu_mask = 0;
+
+	pthread_mutex_lock(&task_mutex);
+
+	for (int i = 0; i < PX4_MAX_AFFINITY_RULES; i++) {
+		if (!affinity_rules[i].name.empty() && (affinity_rules[i].name == name)) {
+			cpu_mask = affinity_rules[i].cpu_mask;
+			break;
+		}
+	}
+
+	pthread_mutex_unlock(&task_mutex);
+
+	return cpu_mask;
+}
+
 int px4_prctl(int option, const char *arg2, px4_task_t pid)
 {
 	int rv = -1;
@@ -432,6 +432,21 @@ int px4_sem_timedwait(px4_sem_t *sem, const struct timespec *ts)
 	return 0;
 }
 
+int px4_task_set_affinity(const char *name, uint32_t cpu_mask)
+{
+	return -ENOTSUP;
+}
+
+uint32_t px4_task_get_affinity(const char *name)
+{
+	return 0;
+}
+
+int px4_thread_set_affinity(pthread_t thread, uint32_t cpu_mask)
+{
+	return -ENOTSUP;
+}
+
 int px4_prctl(int option, const char *arg2, px4_task_t pid)
 {
 	int rv = -1;
@@ -190,6 +190,21 @@ __EXPORT extern void hrt_store_absolute_time(volatile hrt_abstime *time);
 __EXPORT extern int hrt_set_absolute_time_offset(int32_t time_diff_us);
 #endif
 
+#if defined(__PX4_LINUX)
+/**
+ * Select the timer that runs the callouts (POSIX on Linux).
+ * @param timerfd true: absolute timerfd expiries handled by a dedicated thread,
+ *                false: delayed items on the HRT work queue thread
+ * @return 0 on success, -ENOTSUP if timerfd can't be used (lockstep scheduler)
+ */
+__EXPORT extern int hrt_set_timerfd_backend(bool timerfd);
+
+/**
+ * @return true if the callouts run from timerfd expiries
+ */
+__EXPORT extern bool hrt_timerfd_backend(void);
+#endif
+
 /**
  * Call callout(arg) after delay has elapsed.
  *
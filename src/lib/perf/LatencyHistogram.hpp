@@ -0,0 +1,115 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2025 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file LatencyHistogram.hpp
+ *
+ * Histogram of latencies with power-of-two buckets, to estimate percentiles with a fixed and small footprint.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @class LatencyHistogram
+ * Bucket 0 counts latencies below 1 us, bucket i [2^(i-1), 2^i) us and the last bucket everything above.
+ * Not thread-safe, the caller has to serialize add() with the readers if needed.
+ */
+template<int NUM_BUCKETS>
+class LatencyHistogram
+{
+	static_assert(NUM_BUCKETS > 1 && NUM_BUCKETS <= 64, "invalid number of buckets");
+public:
+	static constexpr int buckets_count() { return NUM_BUCKETS; }
+
+	/** @param latency [us] */
+	void add(uint64_t latency)
+	{
+		const int bucket = (latency == 0) ? 0 : (64 - __builtin_clzll(latency));
+		++_buckets[bucket < NUM_BUCKETS ? bucket : NUM_BUCKETS - 1];
+		++_count;
+
+		if (latency > _max) {
+			_max = latency > UINT32_MAX ? UINT32_MAX : (uint32_t)latency;
+		}
+	}
+
+	void reset()
+	{
+		for (uint32_t &bucket : _buckets) {
+			bucket = 0;
+		}
+
+		_count = 0;
+		_max = 0;
+	}
+
+	/**
+	 * @param percent percentile in [0, 100]
+	 * @return upper bound of the bucket containing the percentile, but at most the maximum [us], 0 if empty
+	 */
+	uint32_t percentile(unsigned percent) const
+	{
+		if (_count == 0) {
+			return 0;
+		}
+
+		uint64_t target = ((uint64_t)_count * percent + 99) / 100;
+
+		if (target == 0) {
+			target = 1;
+		}
+
+		uint64_t sum = 0;
+
+		for (int i = 0; i < NUM_BUCKETS - 1; ++i) {
+			sum += _buckets[i];
+
+			if (sum >= target) {
+				return ((1ull << i) < _max) ? (uint32_t)(1ull << i) : _max;
+			}
+		}
+
+		return _max;
+	}
+
+	const uint32_t *buckets() const { return _buckets; }
+	uint32_t count() const { return _count; }
+	uint32_t max() const { return _max; }
+
+private:
+	uint32_t _buckets[NUM_BUCKETS] {};
+	uint32_t _count{0};
+	uint32_t _max{0};
+};
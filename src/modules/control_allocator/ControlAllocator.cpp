@@ -90,7 +90,7 @@ ControlAllocator::~ControlAllocator()
 bool
 ControlAllocator::init()
 {
-	if (!_vehicle_torque_setpoint_sub.registerCallback()) {
+	if (!_setpoint_sync.registerCallbacks()) {
 		PX4_ERR("callback registration failed");
 		return false;
 	}
@@ -303,7 +303,7 @@ void
 ControlAllocator::Run()
 {
 	if (should_exit()) {
-		_vehicle_torque_setpoint_sub.unregisterCallback();
+		_setpoint_sync.unregisterCallbacks();
 		exit_and_cleanup();
 		return;
 	}
@@ -388,6 +388,17 @@ ControlAllocator::Run()
 		do_update = true;
 		_timestamp_sample = vehicle_torque_setpoint.timestamp_sample;
 
+		// derive the setpoint synchronization timeout from the controller rate
+		const hrt_abstime interval = vehicle_torque_setpoint.timestamp - _last_torque_setpoint;
+
+		if ((_last_torque_setpoint != 0) && (interval < 20_ms)) {
+			_torque_setpoint_interval = (_torque_setpoint_interval > 0.f) ?
+						    0.9f * _torque_setpoint_interval + 0.1f * interval : interval;
+			_setpoint_sync.setTimeout(math::constrain((uint32_t)(0.5f * _torque_setpoint_interval), SETPOINT_SYNC_TIMEOUT_MIN,
+						  SETPOINT_SYNC_TIMEOUT_MAX));
+		}
+
+		_last_torque_setpoint = vehicle_torque_setpoint.timestamp;
 	}
 
 	if (_vehicle_thrust_setpoint_sub.update(&vehicle_thrust_setpoint)) {
@@ -68,6 +68,7 @@
 #include <uORB/PublicationMulti.hpp>
 #include <uORB/Subscription.hpp>
 #include <uORB/SubscriptionCallback.hpp>
+#include <uORB/SubscriptionSynchronizer.hpp>
 #include <uORB/topics/actuator_motors.h>
 #include <uORB/topics/actuator_servos.h>
 #include <uORB/topics/actuator_servos_trim.h>
@@ -174,8 +175,14 @@ private:
 	int _num_actuators[(int)ActuatorType::COUNT] {};
 
 	// Inputs
-	uORB::SubscriptionCallbackWorkItem _vehicle_torque_setpoint_sub{this, ORB_ID(vehicle_torque_setpoint)};  /**< vehicle torque setpoint subscription */
-	uORB::Subscription _vehicle_thrust_setpoint_sub{ORB_ID(vehicle_thrust_setpoint)};	 /**< vehicle thrust setpoint subscription */
+	// run once both torque and thrust setpoint are updated, so they are always from the same controller cycle.
+	// The thrust setpoint is waited for at most half the measured controller interval (see Run()), and not at all
+	// if none was published recently
+	static constexpr uint32_t SETPOINT_SYNC_TIMEOUT_MIN = 100;	///< [us]
+	static constexpr uint32_t SETPOINT_SYNC_TIMEOUT_MAX = 5_ms;	///< [us] until the interval is measured
+	uORB::SubscriptionSynchronizer _setpoint_sync{this, SETPOINT_SYNC_TIMEOUT_MAX};
+	uORB::SubscriptionCallbackSynchronized _vehicle_torque_setpoint_sub{&_setpoint_sync, ORB_ID(vehicle_torque_setpoint)};  /**< vehicle torque setpoint subscription */
+	uORB::SubscriptionCallbackSynchronized _vehicle_thrust_setpoint_sub{&_setpoint_sync, ORB_ID(vehicle_thrust_setpoint)};	 /**< vehicle thrust setpoint subscription */
 
 	uORB::Subscription _vehicle_torque_setpoint1_sub{ORB_ID(vehicle_torque_setpoint), 1};  /**< vehicle torque setpoint subscription (2. instance) */
 	uORB::Subscription _vehicle_thrust_setpoint1_sub{ORB_ID(vehicle_thrust_setpoint), 1};	 /**< vehicle thrust setpoint subscription (2. instance) */
@@ -207,6 +214,8 @@ private:
 	hrt_abstime _last_run{0};
 	hrt_abstime _timestamp_sample{0};
 	hrt_abstime _last_status_pub{0};
+	hrt_abstime _last_torque_setpoint{0};
+	float _torque_setpoint_interval{0.f};	///< [us] filtered publication interval of the torque setpoint
 
 	ParamHandles _param_handles{};
 	Params _params{};
@@ -0,0 +1,179 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Offline EKF tuning: replay sensor data (see sensor_simulator/convertULogToSensorData.py)
+ * with many parameter sets, distributed over all cores.
+ *
+ * Usage: ekf2_replay_batch <sensor_data.csv> <param_sets.csv> <output_dir> [num_threads]
+ *
+ * The first line of the parameter file contains the EKF2 parameter names, each following line
+ * one set of values, e.g.:
+ *   EKF2_GPS_V_GATE,EKF2_GPS_P_GATE
+ *   3,3
+ *   5,5
+ * Run i writes the estimator states and variances to <output_dir>/run_<i>.csv.
+ */
+
+#include <cctype>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "sensor_simulator/ekf_replay_batch.h"
+
+static std::vector<std::string> splitLine(const std::string &line)
+{
+	std::vector<std::string> fields;
+	std::stringstream ss(line);
+	std::string field;
+
+	while (getline(ss, field, ',')) {
+		fields.push_back(field);
+	}
+
+	return fields;
+}
+
+static bool isEnd(const char *end)
+{
+	while (isspace((unsigned char)*end)) {
+		++end;
+	}
+
+	return *end == '\0';
+}
+
+static bool parseUnsigned(const char *str, unsigned &value)
+{
+	char *end = nullptr;
+	const unsigned long parsed = strtoul(str, &end, 10);
+
+	if (!isdigit((unsigned char)*str) || !isEnd(end) || parsed > UINT_MAX) {
+		return false;
+	}
+
+	value = parsed;
+	return true;
+}
+
+static bool parseFloat(const char *str, float &value)
+{
+	char *end = nullptr;
+	value = strtof(str, &end);
+	return (end != str) && isEnd(end);
+}
+
+static int usage(const char *name)
+{
+	std::cerr << "Usage: " << name << " <sensor_data.csv> <param_sets.csv> <output_dir> [num_threads]" << std::endl;
+	return 1;
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 4) {
+		return usage(argv[0]);
+	}
+
+	unsigned num_threads = 0;
+
+	if (argc > 4 && !parseUnsigned(argv[4], num_threads)) {
+		std::cerr << "Invalid number of threads: " << argv[4] << std::endl;
+		return usage(argv[0]);
+	}
+
+	std::ifstream param_file(argv[2]);
+	std::string line;
+
+	if (!getline(param_file, line)) {
+		std::cerr << "Cannot read " << argv[2] << std::endl;
+		return 1;
+	}
+
+	const std::vector<std::string> param_names = splitLine(line);
+	parameters check_params{};
+
+	for (const std::string &name : param_names) {
+		if (!EkfReplayBatch::setParam(check_params, name, 0.f)) {
+			std::cerr << "Unknown parameter " << name << std::endl;
+			return 1;
+		}
+	}
+
+	EkfReplayBatch batch(SensorSimulator::readSensorDataFromFile(argv[1]));
+	int line_number = 1;
+
+	while (getline(param_file, line)) {
+		++line_number;
+		const std::vector<std::string> values = splitLine(line);
+
+		if (values.empty()) {
+			continue;
+		}
+
+		if (values.size() != param_names.size()) {
+			std::cerr << "Wrong number of values in line " << line_number << std::endl;
+			return 1;
+		}
+
+		EkfReplayBatch::Run run;
+		run.output_file = std::string(argv[3]) + "/run_" + std::to_string(batch.numRuns()) + ".csv";
+
+		for (size_t i = 0; i < values.size(); ++i) {
+			float value = 0.f;
+
+			if (!parseFloat(values[i].c_str(), value)) {
+				std::cerr << "Invalid value '" << values[i] << "' for " << param_names[i] << " in line " << line_number << std::endl;
+				return 1;
+			}
+
+			run.params.push_back({param_names[i], value});
+		}
+
+		batch.addRun(run);
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	const int failed_runs = batch.runAll(num_threads);
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	std::cout << batch.numRuns() << " runs in " << elapsed.count() << " s (" << failed_runs << " failed)" << std::endl;
+
+	return failed_runs == 0 ? 0 : 1;
+}
@@ -0,0 +1,363 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "ekf_replay_batch.h"
+#include "ekf_logger.h"
+
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+namespace
+{
+
+// EKF2 parameter name to member of the EKF parameters, as in EKF2.cpp
+// (EkfReplayBatchTest.allEstimatorParamsResolve checks that all ParamExt parameters of EKF2.hpp are here)
+struct FloatParam {
+	const char *name;
+	float parameters::*member;
+};
+
+struct IntParam {
+	const char *name;
+	int32_t parameters::*member;
+};
+
+struct VectorParam {
+	const char *name;
+	Vector3f parameters::*member;
+	int index;
+};
+
+const FloatParam float_params[] = {
+	{"EKF2_DELAY_MAX", &parameters::delay_max_ms},
+	{"EKF2_VEL_LIM", &parameters::velocity_limit},
+#if defined(CONFIG_EKF2_AUXVEL)
+	{"EKF2_AVEL_DELAY", &parameters::auxvel_delay_ms},
+#endif // CONFIG_EKF2_AUXVEL
+	{"EKF2_GYR_NOISE", &parameters::gyro_noise},
+	{"EKF2_ACC_NOISE", &parameters::accel_noise},
+	{"EKF2_GYR_B_NOISE", &parameters::gyro_bias_p_noise},
+	{"EKF2_ACC_B_NOISE", &parameters::accel_bias_p_noise},
+#if defined(CONFIG_EKF2_WIND)
+	{"EKF2_WIND_NSD", &parameters::wind_vel_nsd},
+#endif // CONFIG_EKF2_WIND
+	{"EKF2_NOAID_NOISE", &parameters::pos_noaid_noise},
+#if defined(CONFIG_EKF2_GNSS)
+	{"EKF2_GPS_DELAY", &parameters::gps_delay_ms},
+	{"EKF2_GPS_V_NOISE", &parameters::gps_vel_noise},
+	{"EKF2_GPS_P_NOISE", &parameters::gps_pos_noise},
+	{"EKF2_GPS_P_GATE", &parameters::gps_pos_innov_gate},
+	{"EKF2_GPS_V_GATE", &parameters::gps_vel_innov_gate},
+	{"EKF2_REQ_EPH", &parameters::req_hacc},
+	{"EKF2_REQ_EPV", &parameters::req_vacc},
+	{"EKF2_REQ_SACC", &parameters::req_sacc},
+	{"EKF2_REQ_PDOP", &parameters::req_pdop},
+	{"EKF2_REQ_HDRIFT", &parameters::req_hdrift},
+	{"EKF2_REQ_VDRIFT", &parameters::req_vdrift},
+	{"EKF2_GSF_TAS", &parameters::EKFGSF_tas_default},
+#endif // CONFIG_EKF2_GNSS
+#if defined(CONFIG_EKF2_BAROMETER)
+	{"EKF2_BARO_DELAY", &parameters::baro_delay_ms},
+	{"EKF2_BARO_NOISE", &parameters::baro_noise},
+	{"EKF2_BARO_GATE", &parameters::baro_innov_gate},
+	{"EKF2_GND_EFF_DZ", &parameters::gnd_effect_deadzone},
+	{"EKF2_GND_MAX_HGT", &parameters::gnd_effect_max_hgt},
+# if defined(CONFIG_EKF2_BARO_COMPENSATION)
+	{"EKF2_ASPD_MAX", &parameters::max_correction_airspeed},
+	{"EKF2_PCOEF_XP", &parameters::static_pressure_coef_xp},
+	{"EKF2_PCOEF_XN", &parameters::static_pressure_coef_xn},
+	{"EKF2_PCOEF_YP", &parameters::static_pressure_coef_yp},
+	{"EKF2_PCOEF_YN", &parameters::static_pressure_coef_yn},
+	{"EKF2_PCOEF_Z", &parameters::static_pressure_coef_z},
+# endif // CONFIG_EKF2_BARO_COMPENSATION
+#endif // CONFIG_EKF2_BAROMETER
+#if defined(CONFIG_EKF2_AIRSPEED)
+	{"EKF2_ASP_DELAY", &parameters::airspeed_delay_ms},
+	{"EKF2_TAS_GATE", &parameters::tas_innov_gate},
+	{"EKF2_EAS_NOISE", &parameters::eas_noise},
+	{"EKF2_ARSP_THR", &parameters::arsp_thr},
+#endif // CONFIG_EKF2_AIRSPEED
+#if defined(CONFIG_EKF2_SIDESLIP)
+	{"EKF2_BETA_GATE", &parameters::beta_innov_gate},
+	{"EKF2_BETA_NOISE", &parameters::beta_noise},
+#endif // CONFIG_EKF2_SIDESLIP
+#if defined(CONFIG_EKF2_MAGNETOMETER)
+	{"EKF2_MAG_DELAY", &parameters::mag_delay_ms},
+	{"EKF2_MAG_E_NOISE", &parameters::mage_p_noise},
+	{"EKF2_MAG_B_NOISE", &parameters::magb_p_noise},
+	{"EKF2_HEAD_NOISE", &parameters::mag_heading_noise},
+	{"EKF2_MAG_NOISE", &parameters::mag_noise},
+	{"EKF2_MAG_DECL", &parameters::mag_declination_deg},
+	{"EKF2_HDG_GATE", &parameters::heading_innov_gate},
+	{"EKF2_MAG_GATE", &parameters::mag_innov_gate},
+	{"EKF2_MAG_ACCLIM", &parameters::mag_acc_gate},
+	{"EKF2_MAG_CHK_STR", &parameters::mag_check_strength_tolerance_gs},
+	{"EKF2_MAG_CHK_INC", &parameters::mag_check_inclination_tolerance_deg},
+#endif // CONFIG_EKF2_MAGNETOMETER
+#if defined(CONFIG_EKF2_TERRAIN) || defined(CONFIG_EKF2_OPTICAL_FLOW) || defined(CONFIG_EKF2_RANGE_FINDER)
+	{"EKF2_MIN_RNG", &parameters::rng_gnd_clearance},
+#endif // CONFIG_EKF2_TERRAIN || CONFIG_EKF2_OPTICAL_FLOW || CONFIG_EKF2_RANGE_FINDER
+#if defined(CONFIG_EKF2_TERRAIN)
+	{"EKF2_TERR_NOISE", &parameters::terrain_p_noise},
+	{"EKF2_TERR_GRAD", &parameters::terrain_gradient},
+#endif // CONFIG_EKF2_TERRAIN
+#if defined(CONFIG_EKF2_RANGE_FINDER)
+	{"EKF2_RNG_DELAY", &parameters::range_delay_ms},
+	{"EKF2_RNG_NOISE", &parameters::range_noise},
+	{"EKF2_RNG_SFE", &parameters::range_noise_scaler},
+	{"EKF2_RNG_GATE", &parameters::range_innov_gate},
+	{"EKF2_RNG_PITCH", &parameters::rng_sens_pitch},
+	{"EKF2_RNG_A_VMAX", &parameters::max_vel_for_range_aid},
+	{"EKF2_RNG_A_HMAX", &parameters::max_hagl_for_range_aid},
+	{"EKF2_RNG_A_IGATE", &parameters::range_aid_innov_gate},
+	{"EKF2_RNG_QLTY_T", &parameters::range_valid_quality_s},
+	{"EKF2_RNG_K_GATE", &parameters::range_kin_consistency_gate},
+	{"EKF2_RNG_FOG", &parameters::rng_fog},
+#endif // CONFIG_EKF2_RANGE_FINDER
+#if defined(CONFIG_EKF2_EXTERNAL_VISION)
+	{"EKF2_EV_DELAY", &parameters::ev_delay_ms},
+	{"EKF2_EVP_NOISE", &parameters::ev_pos_noise},
+	{"EKF2_EVV_NOISE", &parameters::ev_vel_noise},
+	{"EKF2_EVA_NOISE", &parameters::ev_att_noise},
+	{"EKF2_EVV_GATE", &parameters::ev_vel_innov_gate},
+	{"EKF2_EVP_GATE", &parameters::ev_pos_innov_gate},
+#endif // CONFIG_EKF2_EXTERNAL_VISION
+#if defined(CONFIG_EKF2_OPTICAL_FLOW)
+	{"EKF2_OF_DELAY", &parameters::flow_delay_ms},
+	{"EKF2_OF_N_MIN", &parameters::flow_noise},
+	{"EKF2_OF_N_MAX", &parameters::flow_noise_qual_min},
+	{"EKF2_OF_GATE", &parameters::flow_innov_gate},
+#endif // CONFIG_EKF2_OPTICAL_FLOW
+#if defined(CONFIG_EKF2_DRAG_FUSION)
+	{"EKF2_DRAG_NOISE", &parameters::drag_noise},
+	{"EKF2_BCOEF_X", &parameters::bcoef_x},
+	{"EKF2_BCOEF_Y", &parameters::bcoef_y},
+	{"EKF2_MCOEF", &parameters::mcoef},
+#endif // CONFIG_EKF2_DRAG_FUSION
+#if defined(CONFIG_EKF2_GRAVITY_FUSION)
+	{"EKF2_GRAV_NOISE", &parameters::gravity_noise},
+#endif // CONFIG_EKF2_GRAVITY_FUSION
+	{"EKF2_GBIAS_INIT", &parameters::switch_on_gyro_bias},
+	{"EKF2_ABIAS_INIT", &parameters::switch_on_accel_bias},
+	{"EKF2_ANGERR_INIT", &parameters::initial_tilt_err},
+	{"EKF2_ABL_LIM", &parameters::acc_bias_lim},
+	{"EKF2_ABL_ACCLIM", &parameters::acc_bias_learn_acc_lim},
+	{"EKF2_ABL_GYRLIM", &parameters::acc_bias_learn_gyr_lim},
+	{"EKF2_ABL_TAU", &parameters::acc_bias_learn_tc},
+	{"EKF2_GYR_B_LIM", &parameters::gyro_bias_lim},
+};
+
+const IntParam int_params[] = {
+	{"EKF2_PREDICT_US", &parameters::filter_update_interval_us},
+	{"EKF2_IMU_CTRL", &parameters::imu_ctrl},
+#if defined(CONFIG_EKF2_GNSS)
+	{"EKF2_GPS_CTRL", &parameters::gnss_ctrl},
+	{"EKF2_GPS_CHECK", &parameters::gps_check_mask},
+	{"EKF2_REQ_NSATS", &parameters::req_nsats},
+#endif // CONFIG_EKF2_GNSS
+#if defined(CONFIG_EKF2_BAROMETER)
+	{"EKF2_BARO_CTRL", &parameters::baro_ctrl},
+#endif // CONFIG_EKF2_BAROMETER
+#if defined(CONFIG_EKF2_SIDESLIP)
+	{"EKF2_FUSE_BETA", &parameters::beta_fusion_enabled},
+#endif // CONFIG_EKF2_SIDESLIP
+#if defined(CONFIG_EKF2_MAGNETOMETER)
+	{"EKF2_DECL_TYPE", &parameters::mag_declination_source},
+	{"EKF2_MAG_TYPE", &parameters::mag_fusion_type},
+	{"EKF2_MAG_CHECK", &parameters::mag_check},
+	{"EKF2_SYNT_MAG_Z", &parameters::synthesize_mag_z},
+#endif // CONFIG_EKF2_MAGNETOMETER
+	{"EKF2_HGT_REF", &parameters::height_sensor_ref},
+	{"EKF2_NOAID_TOUT", &parameters::valid_timeout_max},
+#if defined(CONFIG_EKF2_RANGE_FINDER)
+	{"EKF2_RNG_CTRL", &parameters::rng_ctrl},
+#endif // CONFIG_EKF2_RANGE_FINDER
+#if defined(CONFIG_EKF2_EXTERNAL_VISION)
+	{"EKF2_EV_CTRL", &parameters::ev_ctrl},
+	{"EKF2_EV_QMIN", &parameters::ev_quality_minimum},
+#endif // CONFIG_EKF2_EXTERNAL_VISION
+#if defined(CONFIG_EKF2_OPTICAL_FLOW)
+	{"EKF2_OF_CTRL", &parameters::flow_ctrl},
+	{"EKF2_OF_GYR_SRC", &parameters::flow_gyro_src},
+	{"EKF2_OF_QMIN", &parameters::flow_qual_min},
+	{"EKF2_OF_QMIN_GND", &parameters::flow_qual_min_gnd},
+#endif // CONFIG_EKF2_OPTICAL_FLOW
+#if defined(CONFIG_EKF2_DRAG_FUSION)
+	{"EKF2_DRAG_CTRL", &parameters::drag_ctrl},
+#endif // CONFIG_EKF2_DRAG_FUSION
+};
+
+const VectorParam vector_params[] = {
+#if defined(CONFIG_EKF2_GNSS)
+	{"EKF2_GPS_POS_X", &parameters::gps_pos_body, 0},
+	{"EKF2_GPS_POS_Y", &parameters::gps_pos_body, 1},
+	{"EKF2_GPS_POS_Z", &parameters::gps_pos_body, 2},
+#endif // CONFIG_EKF2_GNSS
+#if defined(CONFIG_EKF2_RANGE_FINDER)
+	{"EKF2_RNG_POS_X", &parameters::rng_pos_body, 0},
+	{"EKF2_RNG_POS_Y", &parameters::rng_pos_body, 1},
+	{"EKF2_RNG_POS_Z", &parameters::rng_pos_body, 2},
+#endif // CONFIG_EKF2_RANGE_FINDER
+#if defined(CONFIG_EKF2_EXTERNAL_VISION)
+	{"EKF2_EV_POS_X", &parameters::ev_pos_body, 0},
+	{"EKF2_EV_POS_Y", &parameters::ev_pos_body, 1},
+	{"EKF2_EV_POS_Z", &parameters::ev_pos_body, 2},
+#endif // CONFIG_EKF2_EXTERNAL_VISION
+#if defined(CONFIG_EKF2_OPTICAL_FLOW)
+	{"EKF2_OF_POS_X", &parameters::flow_pos_body, 0},
+	{"EKF2_OF_POS_Y", &parameters::flow_pos_body, 1},
+	{"EKF2_OF_POS_Z", &parameters::flow_pos_body, 2},
+#endif // CONFIG_EKF2_OPTICAL_FLOW
+	{"EKF2_IMU_POS_X", &parameters::imu_pos_body, 0},
+	{"EKF2_IMU_POS_Y", &parameters::imu_pos_body, 1},
+	{"EKF2_IMU_POS_Z", &parameters::imu_pos_body, 2},
+};
+
+} // namespace
+
+EkfReplayBatch::EkfReplayBatch(std::shared_ptr<const std::vector<sensor_info>> replay_data):
+	_replay_data{replay_data}
+{
+	// start the sensors that are contained in the data (IMU, mag and baro are always running)
+	for (const sensor_info &sample : *_replay_data) {
+		_has_gps |= sample.sensor_type == sensor_info::measurement_t::GPS;
+		_has_flow |= sample.sensor_type == sensor_info::measurement_t::FLOW;
+		_has_range |= sample.sensor_type == sensor_info::measurement_t::RANGE;
+		_has_airspeed |= sample.sensor_type == sensor_info::measurement_t::AIRSPEED;
+	}
+}
+
+bool EkfReplayBatch::setParam(parameters &params, const std::string &name, float value)
+{
+	for (const FloatParam &param : float_params) {
+		if (name == param.name) {
+			params.*param.member = value;
+			return true;
+		}
+	}
+
+	for (const IntParam &param : int_params) {
+		if (name == param.name) {
+			params.*param.member = static_cast<int32_t>(lroundf(value));
+			return true;
+		}
+	}
+
+	for (const VectorParam &param : vector_params) {
+		if (name == param.name) {
+			(params.*param.member)(param.index) = value;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int EkfReplayBatch::runAll(unsigned num_threads)
+{
+	if (num_threads == 0) {
+		num_threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	num_threads = std::min<size_t>(num_threads, _runs.size());
+
+	// the runs are independent: the workers only share the (read-only) sensor data
+	std::atomic<size_t> next_run{0};
+	std::atomic<int> failed_runs{0};
+
+	auto worker = [&]() {
+		for (size_t run = next_run++; run < _runs.size(); run = next_run++) {
+			if (!runSingle(_runs[run])) {
+				failed_runs++;
+			}
+		}
+	};
+
+	std::vector<std::thread> threads;
+
+	for (unsigned i = 1; i < num_threads; ++i) {
+		threads.emplace_back(worker);
+	}
+
+	worker();
+
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+
+	return failed_runs;
+}
+
+bool EkfReplayBatch::runSingle(const Run &run) const
+{
+	std::shared_ptr<Ekf> ekf = std::make_shared<Ekf>();
+
+	for (const ParamOverride &param : run.params) {
+		if (!setParam(*ekf->getParamHandle(), param.name, param.value)) {
+			std::cerr << "Unknown parameter " << param.name << std::endl;
+			return false;
+		}
+	}
+
+	SensorSimulator sensor_simulator(ekf);
+	sensor_simulator.setSensorData(_replay_data);
+
+	if (_has_gps) {
+		sensor_simulator.startGps();
+	}
+
+	if (_has_flow) {
+		sensor_simulator.startFlow();
+	}
+
+	if (_has_range) {
+		sensor_simulator.startRangeFinder();
+	}
+
+	if (_has_airspeed) {
+		sensor_simulator.startAirspeedSensor();
+	}
+
+	EkfLogger ekf_logger(ekf);
+	ekf_logger.setFilePath(run.output_file);
+
+	const uint32_t logging_interval_us = static_cast<uint32_t>(1e6f / _logging_rate_hz);
+
+	while (!sensor_simulator.isReplayFinished()) {
+		sensor_simulator.runReplayMicroseconds(logging_interval_us);
+		ekf_logger.writeStateToFile();
+	}
+
+	return true;
+}
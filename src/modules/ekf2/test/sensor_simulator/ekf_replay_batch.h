@@ -0,0 +1,96 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Replays sensor data with many EKF parameter sets in parallel, e.g. for offline tuning.
+ * The sensor data is loaded once and shared, each parameter set runs on its own Ekf instance
+ * and writes the estimator states to its own file.
+ */
+
+#ifndef EKF_EKF_REPLAY_BATCH_H
+#define EKF_EKF_REPLAY_BATCH_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sensor_simulator.h"
+
+class EkfReplayBatch
+{
+public:
+	struct ParamOverride {
+		std::string name; ///< EKF2 parameter name, e.g. EKF2_GPS_V_GATE
+		float value;
+	};
+
+	struct Run {
+		std::vector<ParamOverride> params;
+		std::string output_file; ///< state and variance log, see EkfLogger
+	};
+
+	EkfReplayBatch(std::shared_ptr<const std::vector<sensor_info>> replay_data);
+	~EkfReplayBatch() = default;
+
+	void addRun(const Run &run) { _runs.push_back(run); }
+	size_t numRuns() const { return _runs.size(); }
+
+	void setLoggingRateHz(float rate) { _logging_rate_hz = rate; }
+
+	/**
+	 * Replay the sensor data for all runs, distributed over a pool of threads.
+	 * @param num_threads number of worker threads, 0 to use all cores
+	 * @return number of failed runs (unknown parameter)
+	 */
+	int runAll(unsigned num_threads = 0);
+
+	/**
+	 * Set an EKF parameter by its EKF2 parameter name (integer parameters are rounded)
+	 * @return false if the parameter is unknown
+	 */
+	static bool setParam(parameters &params, const std::string &name, float value);
+
+private:
+	bool runSingle(const Run &run) const;
+
+	std::shared_ptr<const std::vector<sensor_info>> _replay_data;
+	std::vector<Run> _runs;
+
+	float _logging_rate_hz{10.f};
+
+	bool _has_gps{false};
+	bool _has_flow{false};
+	bool _has_range{false};
+	bool _has_airspeed{false};
+};
+#endif // !EKF_EKF_REPLAY_BATCH_H
@@ -119,6 +119,14 @@ public:
 
 	void loadSensorDataFromFile(std::string filename);
 
+	/**
+	 * Read replay data (see convertULogToSensorData.py) once, so that it can be shared by multiple simulators
+	 */
+	static std::shared_ptr<const std::vector<sensor_info>> readSensorDataFromFile(std::string filename);
+	void setSensorData(std::shared_ptr<const std::vector<sensor_info>> replay_data);
+
+	bool isReplayFinished() const { return !_replay_data || _current_replay_data_index >= _replay_data->size(); }
+
 	Airspeed    _airspeed;
 	Baro        _baro;
 	Flow        _flow;
@@ -141,7 +149,7 @@ private:
 
 	std::shared_ptr<Ekf> _ekf{nullptr};
 
-	std::vector<sensor_info> _replay_data{};
+	std::shared_ptr<const std::vector<sensor_info>> _replay_data{};
 
 	bool _has_replay_data{false};
 
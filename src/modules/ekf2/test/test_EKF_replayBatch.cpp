@@ -0,0 +1,214 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include <gtest/gtest.h>
+#include <fstream>
+#include <memory>
+#include <regex>
+#include <set>
+#include <sstream>
+#include <vector>
+#include "EKF/ekf.h"
+#include "sensor_simulator/ekf_replay_batch.h"
+
+static std::string readFile(const std::string &file_name)
+{
+	std::ifstream file(file_name);
+	std::stringstream content;
+	content << file.rdbuf();
+	return content.str();
+}
+
+TEST(EkfReplayBatchTest, setParam)
+{
+	parameters params{};
+
+	EXPECT_TRUE(EkfReplayBatch::setParam(params, "EKF2_GPS_V_GATE", 2.5f));
+	EXPECT_FLOAT_EQ(params.gps_vel_innov_gate, 2.5f);
+
+	EXPECT_TRUE(EkfReplayBatch::setParam(params, "EKF2_GPS_CTRL", 7.f));
+	EXPECT_EQ(params.gnss_ctrl, 7);
+
+	EXPECT_TRUE(EkfReplayBatch::setParam(params, "EKF2_IMU_POS_Y", 0.1f));
+	EXPECT_FLOAT_EQ(params.imu_pos_body(1), 0.1f);
+
+	EXPECT_FALSE(EkfReplayBatch::setParam(params, "EKF2_NOT_A_PARAM", 1.f));
+}
+
+// EKF2 Kconfig options guarding parameters in EKF2.hpp, enabled in this build
+static const std::set<std::string> ekf2_configs_enabled = {
+#if defined(CONFIG_EKF2_AIRSPEED)
+	"CONFIG_EKF2_AIRSPEED",
+#endif
+#if defined(CONFIG_EKF2_AUXVEL)
+	"CONFIG_EKF2_AUXVEL",
+#endif
+#if defined(CONFIG_EKF2_BAROMETER)
+	"CONFIG_EKF2_BAROMETER",
+#endif
+#if defined(CONFIG_EKF2_BARO_COMPENSATION)
+	"CONFIG_EKF2_BARO_COMPENSATION",
+#endif
+#if defined(CONFIG_EKF2_DRAG_FUSION)
+	"CONFIG_EKF2_DRAG_FUSION",
+#endif
+#if defined(CONFIG_EKF2_EXTERNAL_VISION)
+	"CONFIG_EKF2_EXTERNAL_VISION",
+#endif
+#if defined(CONFIG_EKF2_GNSS)
+	"CONFIG_EKF2_GNSS",
+#endif
+#if defined(CONFIG_EKF2_GNSS_YAW)
+	"CONFIG_EKF2_GNSS_YAW",
+#endif
+#if defined(CONFIG_EKF2_GRAVITY_FUSION)
+	"CONFIG_EKF2_GRAVITY_FUSION",
+#endif
+#if defined(CONFIG_EKF2_MAGNETOMETER)
+	"CONFIG_EKF2_MAGNETOMETER",
+#endif
+#if defined(CONFIG_EKF2_MULTI_INSTANCE)
+	"CONFIG_EKF2_MULTI_INSTANCE",
+#endif
+#if defined(CONFIG_EKF2_OPTICAL_FLOW)
+	"CONFIG_EKF2_OPTICAL_FLOW",
+#endif
+#if defined(CONFIG_EKF2_RANGE_FINDER)
+	"CONFIG_EKF2_RANGE_FINDER",
+#endif
+#if defined(CONFIG_EKF2_SIDESLIP)
+	"CONFIG_EKF2_SIDESLIP",
+#endif
+#if defined(CONFIG_EKF2_TERRAIN)
+	"CONFIG_EKF2_TERRAIN",
+#endif
+#if defined(CONFIG_EKF2_WIND)
+	"CONFIG_EKF2_WIND",
+#endif
+};
+
+static const std::set<std::string> ekf2_configs_known = {
+	"CONFIG_EKF2_AIRSPEED", "CONFIG_EKF2_AUXVEL", "CONFIG_EKF2_BAROMETER", "CONFIG_EKF2_BARO_COMPENSATION",
+	"CONFIG_EKF2_DRAG_FUSION", "CONFIG_EKF2_EXTERNAL_VISION", "CONFIG_EKF2_GNSS", "CONFIG_EKF2_GNSS_YAW",
+	"CONFIG_EKF2_GRAVITY_FUSION", "CONFIG_EKF2_MAGNETOMETER", "CONFIG_EKF2_MULTI_INSTANCE", "CONFIG_EKF2_OPTICAL_FLOW",
+	"CONFIG_EKF2_RANGE_FINDER", "CONFIG_EKF2_SIDESLIP", "CONFIG_EKF2_TERRAIN", "CONFIG_EKF2_WIND",
+};
+
+TEST(EkfReplayBatchTest, allEstimatorParamsResolve)
+{
+	// Every parameter that EKF2 binds to the estimator parameters (ParamExtFloat/ParamExtInt) must be settable.
+	// EKF2.hpp is parsed with its CONFIG_EKF2_* conditions, to compare with the table built with the same options.
+	std::ifstream file(TEST_DATA_PATH"/../EKF2.hpp");
+	ASSERT_TRUE(file.good());
+
+	const std::regex guard_regex(R"(^\s*#\s*(ifdef|ifndef)\b)");
+	const std::regex condition_regex(R"(^\s*#\s*if\s+(.*)$)");
+	const std::regex else_regex(R"(^\s*#\s*(else|elif)\b)");
+	const std::regex endif_regex(R"(^\s*#\s*endif\b)");
+	const std::regex defined_regex(R"(defined\((\w+)\))");
+	const std::regex param_regex(R"(ParamExt(Float|Int)<px4::params::(EKF2_\w+)>)");
+
+	std::vector<bool> active; // one entry per open #if/#ifdef/#ifndef
+	int num_params = 0;
+	std::string line;
+
+	while (std::getline(file, line)) {
+		std::smatch match;
+
+		if (std::regex_search(line, guard_regex)) {
+			active.push_back(true); // include guard
+
+		} else if (std::regex_match(line, match, condition_regex)) {
+			const std::string condition = match[1];
+			ASSERT_EQ(condition.find_first_of("&!"), std::string::npos) << "unsupported condition: " << line;
+
+			bool enabled = false;
+
+			for (std::sregex_iterator it(condition.begin(), condition.end(), defined_regex), end; it != end; ++it) {
+				const std::string config = (*it)[1];
+				ASSERT_EQ(ekf2_configs_known.count(config), 1u) << "add " << config << " to the EKF2 configs of this test";
+				enabled |= ekf2_configs_enabled.count(config) > 0;
+			}
+
+			active.push_back(enabled);
+
+		} else if (std::regex_search(line, else_regex)) {
+			FAIL() << "unsupported directive: " << line;
+
+		} else if (std::regex_search(line, endif_regex)) {
+			ASSERT_FALSE(active.empty());
+			active.pop_back();
+
+		} else if (std::regex_search(line, match, param_regex)) {
+			bool enabled = true;
+
+			for (bool a : active) {
+				enabled &= a;
+			}
+
+			if (enabled) {
+				parameters params{};
+				EXPECT_TRUE(EkfReplayBatch::setParam(params, match[2], 1.f)) << match[2] << " is not known to EkfReplayBatch";
+				++num_params;
+			}
+		}
+	}
+
+	EXPECT_GT(num_params, 0);
+}
+
+TEST(EkfReplayBatchTest, runsAreIndependent)
+{
+	const std::string output_path = ::testing::TempDir() + "ekf_replay_batch_";
+	EkfReplayBatch batch(SensorSimulator::readSensorDataFromFile(TEST_DATA_PATH"/replay_data/iris_gps.csv"));
+
+	// the same parameter set twice and a different one, running concurrently
+	batch.addRun({{}, output_path + "0.csv"});
+	batch.addRun({{{"EKF2_GYR_NOISE", 0.1f}}, output_path + "1.csv"});
+	batch.addRun({{}, output_path + "2.csv"});
+
+	EXPECT_EQ(batch.runAll(3), 0);
+
+	const std::string run0 = readFile(output_path + "0.csv");
+	EXPECT_FALSE(run0.empty());
+	EXPECT_EQ(run0, readFile(output_path + "2.csv"));
+	EXPECT_NE(run0, readFile(output_path + "1.csv"));
+}
+
+TEST(EkfReplayBatchTest, unknownParameter)
+{
+	EkfReplayBatch batch(SensorSimulator::readSensorDataFromFile(TEST_DATA_PATH"/replay_data/iris_gps.csv"));
+	batch.addRun({{{"EKF2_NOT_A_PARAM", 1.f}}, ::testing::TempDir() + "ekf_replay_batch_invalid.csv"});
+
+	EXPECT_EQ(batch.runAll(), 1);
+}
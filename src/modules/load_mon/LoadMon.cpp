@@ -101,6 +101,10 @@ void LoadMon::Run()
 
 	cpuload();
 
+#if defined(CONFIG_PX4_WORK_QUEUE_LATENCY)
+	work_item_latency();
+#endif
+
 #if defined(__PX4_NUTTX)
 
 	if (_param_sys_stck_en.get()) {
@@ -120,6 +124,55 @@ void LoadMon::Run()
 	perf_end(_cycle_perf);
 }
 
+#if defined(CONFIG_PX4_WORK_QUEUE_LATENCY)
+void LoadMon::work_item_latency()
+{
+	// Only a few work items per cycle, in turns: the whole list in one burst would overrun the
+	// topic queue. Nothing is published from within the iteration, which holds the manager lock.
+	_work_item_latency_count = 0;
+	_work_item_latency_visited = 0;
+	px4::WorkQueueManagerForEachItem(&LoadMon::collect_work_item_latency, this);
+
+	const hrt_abstime now = hrt_absolute_time();
+
+	for (int i = 0; i < _work_item_latency_count; i++) {
+		_work_item_latency[i].timestamp = now;
+		_work_item_latency_pub.publish(_work_item_latency[i]);
+	}
+
+	_work_item_latency_index += _work_item_latency_count;
+
+	if (_work_item_latency_index >= _work_item_latency_visited) {
+		_work_item_latency_index = 0;
+	}
+}
+
+void LoadMon::collect_work_item_latency(const px4::WorkQueue &wq, const px4::WorkItem &item, void *arg)
+{
+	LoadMon *load_mon = static_cast<LoadMon *>(arg);
+
+	const int index = load_mon->_work_item_latency_visited++;
+
+	if ((index < load_mon->_work_item_latency_index) || (load_mon->_work_item_latency_count >= WORK_ITEM_LATENCY_BATCH)) {
+		return;
+	}
+
+	work_item_latency_s &work_item_latency = load_mon->_work_item_latency[load_mon->_work_item_latency_count++];
+	work_item_latency = {};
+	strncpy(work_item_latency.item_name, item.ItemName(), sizeof(work_item_latency.item_name) - 1);
+	strncpy(work_item_latency.wq_name, wq.get_name(), sizeof(work_item_latency.wq_name) - 1);
+
+	const px4::WorkItem::SchedulingLatencyHistogram &histogram = item.latency_histogram();
+	work_item_latency.latency_p50 = histogram.percentile(50);
+	work_item_latency.latency_p99 = histogram.percentile(99);
+	work_item_latency.latency_max = histogram.max();
+
+	static_assert(sizeof(work_item_latency.latency_histogram) / sizeof(work_item_latency.latency_histogram[0])
+		      == px4::WorkItem::LATENCY_HISTOGRAM_BUCKETS, "work_item_latency histogram size mismatch");
+	memcpy(work_item_latency.latency_histogram, histogram.buckets(), sizeof(work_item_latency.latency_histogram));
+}
+#endif // CONFIG_PX4_WORK_QUEUE_LATENCY
+
 void LoadMon::cpuload()
 {
 #if defined(__PX4_LINUX)
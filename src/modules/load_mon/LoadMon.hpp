@@ -48,6 +48,10 @@
 #include <uORB/topics/cpuload.h>
 #include <uORB/topics/task_stack_info.h>
 
+#if defined(CONFIG_PX4_WORK_QUEUE_LATENCY)
+#include <uORB/topics/work_item_latency.h>
+#endif
+
 #if defined(__PX4_LINUX)
 #include <sys/times.h>
 #endif
@@ -81,6 +85,24 @@ private:
 	/** Do a calculation of the CPU load and publish it. */
 	void cpuload();
 
+#if defined(CONFIG_PX4_WORK_QUEUE_LATENCY)
+	/** Publish the scheduling latency statistics of the next few work items. */
+	void work_item_latency();
+
+	/** WorkQueueManagerForEachItem() callback, only copies the statistics of the current batch. */
+	static void collect_work_item_latency(const px4::WorkQueue &wq, const px4::WorkItem &item, void *arg);
+
+	// the topic is queued (ORB_QUEUE_LENGTH 16), stay well below it per cycle
+	static constexpr int WORK_ITEM_LATENCY_BATCH = 4;
+
+	work_item_latency_s _work_item_latency[WORK_ITEM_LATENCY_BATCH] {};
+	int _work_item_latency_count{0};   ///< number of collected entries in the current batch
+	int _work_item_latency_index{0};   ///< index of the first work item of the current batch
+	int _work_item_latency_visited{0}; ///< number of work items visited in the current iteration
+
+	uORB::Publication<work_item_latency_s> _work_item_latency_pub{ORB_ID(work_item_latency)};
+#endif // CONFIG_PX4_WORK_QUEUE_LATENCY
+
 	/* Stack check only available on Nuttx */
 #if defined(__PX4_NUTTX)
 	/* Calculate stack usage */
@@ -0,0 +1,126 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#include "backpressure.h"
+
+namespace px4
+{
+namespace logger
+{
+
+bool BackpressureController::update(size_t buffer_fill, size_t buffer_size, hrt_abstime write_stall, hrt_abstime now)
+{
+	if (buffer_size == 0) {
+		return false;
+	}
+
+	// raise above 50% buffer fill, lower below 20% (hysteresis)
+	const bool pressure = buffer_fill * 2 > buffer_size || write_stall > RAISE_STALL;
+	const bool relaxed = buffer_fill * 5 < buffer_size && write_stall < LOWER_STALL;
+
+	if (!relaxed) {
+		_relaxed_since = 0;
+
+	} else if (_relaxed_since == 0) {
+		_relaxed_since = now;
+	}
+
+	if (pressure) {
+		if (_level < MAX_LEVEL && (_level == 0 || now >= _last_change + RAISE_INTERVAL)) {
+			++_level;
+			_last_change = now;
+			return true;
+		}
+
+	} else if (_level > 0 && relaxed && now >= _relaxed_since + LOWER_HOLD && now >= _last_change + LOWER_HOLD) {
+		// one level at a time, each after the full hold time
+		--_level;
+		_last_change = now;
+		return true;
+	}
+
+	return false;
+}
+
+void BackpressureController::reset()
+{
+	_level = 0;
+	_last_change = 0;
+	_relaxed_since = 0;
+}
+
+uint32_t BackpressureController::interval_us(TopicPriority priority, uint32_t configured_interval_us) const
+{
+	int shift = 0;
+
+	switch (priority) {
+	case TopicPriority::Low:
+		shift = _level;
+		break;
+
+	case TopicPriority::Normal:
+		shift = _level - 2;
+		break;
+
+	case TopicPriority::Critical:
+		break;
+	}
+
+	if (shift <= 0 || configured_interval_us >= MAX_INTERVAL) {
+		return configured_interval_us;
+	}
+
+	const uint32_t base_interval = configured_interval_us > MIN_INTERVAL ? configured_interval_us : MIN_INTERVAL;
+	const uint32_t interval = base_interval << shift;
+	return interval < MAX_INTERVAL ? interval : MAX_INTERVAL;
+}
+
+bool BackpressureController::shed(TopicPriority priority, size_t buffer_fill, size_t buffer_size)
+{
+	switch (priority) {
+	case TopicPriority::Low:
+		return buffer_fill * 2 > buffer_size; // above 50%
+
+	case TopicPriority::Normal:
+		return buffer_fill * 4 > buffer_size * 3; // above 75%
+
+	case TopicPriority::Critical:
+		break;
+	}
+
+	return false;
+}
+
+} //namespace logger
+} //namespace px4
@@ -0,0 +1,104 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <drivers/drv_hrt.h>
+
+#include "logged_topics.h"
+
+namespace px4
+{
+namespace logger
+{
+
+/**
+ * @class BackpressureController
+ * Reduces the logging rate of low-priority topics when the log cannot be written fast enough, based on the fill
+ * level of the write buffer and the duration of the ongoing file write (SD card stalls).
+ * Each level doubles the intervals of the low-priority topics, and from level 3 on the normal-priority topics are
+ * reduced as well. Critical topics are never reduced. When the buffer is close to full, samples of non-critical
+ * topics are dropped before they reach the buffer, so that the remaining space is kept for the critical ones.
+ */
+class BackpressureController
+{
+public:
+	static constexpr int MAX_LEVEL = 4;
+
+	/**
+	 * Update the level
+	 * @param buffer_fill bytes in the write buffer
+	 * @param buffer_size size of the write buffer
+	 * @param write_stall duration of the ongoing file write [us], 0 if there is none
+	 * @param now current time
+	 * @return true if the level changed (the subscription intervals need to be updated)
+	 */
+	bool update(size_t buffer_fill, size_t buffer_size, hrt_abstime write_stall, hrt_abstime now);
+
+	/**
+	 * Go back to level 0 (call on log start)
+	 */
+	void reset();
+
+	int level() const { return _level; }
+
+	/**
+	 * Get the interval of a topic for the current level
+	 * @param configured_interval_us interval without pressure [us]
+	 */
+	uint32_t interval_us(TopicPriority priority, uint32_t configured_interval_us) const;
+
+	/**
+	 * Check if a sample needs to be dropped to keep the buffer space for higher-priority topics
+	 */
+	static bool shed(TopicPriority priority, size_t buffer_fill, size_t buffer_size);
+
+private:
+	static constexpr hrt_abstime RAISE_INTERVAL{100000};	///< min time between raising the level [us]
+	static constexpr hrt_abstime RAISE_STALL{100000};	///< write stall that raises the level [us]
+	static constexpr hrt_abstime LOWER_HOLD{2000000};	///< time without pressure before lowering the level [us]
+	static constexpr hrt_abstime LOWER_STALL{20000};	///< max write stall to lower the level [us]
+	static constexpr uint32_t MIN_INTERVAL{10000};		///< base interval for full-rate topics [us]
+	static constexpr uint32_t MAX_INTERVAL{1000000};	///< intervals are not increased beyond this [us]
+
+	int _level{0};
+	hrt_abstime _last_change{0};
+	hrt_abstime _relaxed_since{0};	///< start of the period without pressure, 0 if there is pressure
+};
+
+} //namespace logger
+} //namespace px4
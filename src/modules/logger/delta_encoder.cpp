@@ -0,0 +1,219 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "delta_encoder.h"
+#include "messages.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace px4
+{
+namespace logger
+{
+
+DeltaEncoder::DeltaEncoder(const orb_metadata *meta) :
+	_meta(meta),
+	_size(meta->o_size_no_padding)
+{
+	_previous = new uint8_t[_size];
+	_field_end[0] = _size;
+}
+
+DeltaEncoder::~DeltaEncoder()
+{
+	delete[](_previous);
+}
+
+bool DeltaEncoder::enabled_for(ORB_ID id)
+{
+	switch (id) {
+	case ORB_ID::sensor_combined:
+	case ORB_ID::vehicle_angular_velocity:
+	case ORB_ID::sensor_accel_fifo:
+	case ORB_ID::sensor_gyro_fifo:
+	case ORB_ID::estimator_states:
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+size_t DeltaEncoder::base_type_size(const char *type, size_t length)
+{
+	static constexpr struct {
+		const char *name;
+		size_t size;
+	} base_types[] = {
+		{"int8_t", 1}, {"uint8_t", 1}, {"char", 1}, {"bool", 1},
+		{"int16_t", 2}, {"uint16_t", 2},
+		{"int32_t", 4}, {"uint32_t", 4}, {"float", 4},
+		{"int64_t", 8}, {"uint64_t", 8}, {"double", 8},
+	};
+
+	for (const auto &base_type : base_types) {
+		if (strlen(base_type.name) == length && strncmp(base_type.name, type, length) == 0) {
+			return base_type.size;
+		}
+	}
+
+	return 0;
+}
+
+void DeltaEncoder::set_fields(const char *fields, size_t length)
+{
+	const char *const end = fields + length;
+	const char *field = fields;
+	size_t offset = 0;
+	_num_fields = 0;
+
+	// A field that cannot be parsed (e.g. a nested type) ends the parsing: the remaining bytes are treated as one
+	// field, which only affects the encoding efficiency, not the correctness.
+	while (field < end && _num_fields < MAX_FIELDS - 1) {
+		const char *field_end = (const char *)memchr(field, ';', end - field);
+		const char *type_end = (const char *)memchr(field, ' ', end - field);
+
+		if (!field_end || !type_end || type_end > field_end) {
+			break;
+		}
+
+		const char *array_start = (const char *)memchr(field, '[', type_end - field);
+		size_t array_size = 1;
+
+		if (array_start) {
+			array_size = strtoul(array_start + 1, nullptr, 10);
+		}
+
+		const size_t type_size = base_type_size(field, (array_start ? array_start : type_end) - field);
+
+		if (type_size == 0 || array_size == 0) {
+			break;
+		}
+
+		offset += type_size * array_size;
+
+		if (offset >= _size) {
+			break;
+		}
+
+		_field_end[_num_fields++] = offset;
+		field = field_end + 1;
+	}
+
+	_field_end[_num_fields++] = _size;
+}
+
+bool DeltaEncoder::field_changed(const uint8_t *sample, int field) const
+{
+	const uint16_t start = field_start(field);
+	return memcmp(sample + start, _previous + start, _field_end[field] - start) != 0;
+}
+
+size_t DeltaEncoder::encode(uint16_t msg_id, const uint8_t *sample, uint8_t *buffer, hrt_abstime now)
+{
+	if (!_has_previous || now >= _keyframe_time + KEYFRAME_INTERVAL) {
+		return 0;
+	}
+
+	// a delta that is not smaller than the regular message is not worth it
+	const size_t max_size = sizeof(ulog_message_data_s) + _size - 1;
+	size_t size = sizeof(ulog_message_data_delta_s);
+	int field = 0;
+
+	while (field < _num_fields) {
+		if (!field_changed(sample, field)) {
+			++field;
+			continue;
+		}
+
+		// extend the run over the following changed fields, and over unchanged fields that are shorter than a run header
+		const uint16_t run_start = field_start(field);
+		uint16_t run_end = _field_end[field++];
+
+		while (field < _num_fields) {
+			if (field_changed(sample, field)) {
+				run_end = _field_end[field++];
+
+			} else if (field + 1 < _num_fields
+				   && (size_t)(_field_end[field] - field_start(field)) < sizeof(ulog_message_data_delta_run_s)
+				   && field_changed(sample, field + 1)) {
+				run_end = _field_end[field + 1];
+				field += 2;
+
+			} else {
+				break;
+			}
+		}
+
+		for (uint16_t offset = run_start; offset < run_end;) {
+			ulog_message_data_delta_run_s run;
+			run.offset = offset;
+			run.length = (run_end - offset > UINT8_MAX) ? UINT8_MAX : run_end - offset;
+
+			if (size + sizeof(run) + run.length > max_size) {
+				return 0;
+			}
+
+			memcpy(buffer + size, &run, sizeof(run));
+			size += sizeof(run);
+
+			for (int i = 0; i < run.length; ++i) {
+				buffer[size++] = sample[offset + i] ^ _previous[offset + i];
+			}
+
+			offset += run.length;
+		}
+	}
+
+	const uint16_t msg_size = size - ULOG_MSG_HEADER_LEN;
+	buffer[0] = (uint8_t)msg_size;
+	buffer[1] = (uint8_t)(msg_size >> 8);
+	buffer[2] = static_cast<uint8_t>(ULogMessageType::DATA_DELTA);
+	buffer[3] = (uint8_t)msg_id;
+	buffer[4] = (uint8_t)(msg_id >> 8);
+	return size;
+}
+
+void DeltaEncoder::written(const uint8_t *sample, bool keyframe, hrt_abstime now)
+{
+	memcpy(_previous, sample, _size);
+	_has_previous = true;
+
+	if (keyframe) {
+		_keyframe_time = now;
+	}
+}
+
+} //namespace logger
+} //namespace px4
@@ -0,0 +1,127 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <drivers/drv_hrt.h>
+#include <uORB/uORB.h>
+#include <uORB/topics/uORBTopics.hpp>
+
+namespace px4
+{
+namespace logger
+{
+
+/**
+ * @class DeltaEncoder
+ * Encodes the samples of a logged topic as DATA_DELTA messages against the previously written sample.
+ * The changed bytes are grouped at field boundaries (taken from the topic's ULog format) into runs.
+ * A full DATA message (keyframe) is written periodically, or whenever the delta would not be smaller.
+ */
+class DeltaEncoder
+{
+public:
+	static constexpr int MAX_FIELDS = 64;
+	static constexpr hrt_abstime KEYFRAME_INTERVAL = 1000000; ///< [us]
+
+	/**
+	 * @param meta logged topic, the encoder operates on o_size_no_padding bytes
+	 */
+	DeltaEncoder(const orb_metadata *meta);
+	~DeltaEncoder();
+
+	DeltaEncoder(const DeltaEncoder &) = delete;
+	DeltaEncoder &operator=(const DeltaEncoder &) = delete;
+
+	/**
+	 * Check if a topic should be delta encoded (high-rate topics where consecutive samples differ in few fields)
+	 */
+	static bool enabled_for(ORB_ID id);
+
+	/** @return false if the allocation failed */
+	bool valid() const { return _previous != nullptr; }
+
+	const orb_metadata *topic() const { return _meta; }
+
+	/**
+	 * Set the field boundaries from the ULog format of the topic.
+	 * @param fields format fields in the form 'type name;type name;...' (without the topic name)
+	 * @param length string length of fields
+	 */
+	void set_fields(const char *fields, size_t length);
+
+	/**
+	 * Forget the previous sample, so that the next one is written as keyframe (call on log start).
+	 */
+	void reset() { _has_previous = false; }
+
+	/**
+	 * Encode a sample as DATA_DELTA message.
+	 * @param msg_id logger message id of the subscription
+	 * @param sample current sample
+	 * @param buffer output buffer for the message (at least sizeof(ulog_message_data_s) + o_size_no_padding bytes)
+	 * @param now current time
+	 * @return size of the encoded message, or 0 if the sample needs to be written as regular DATA message
+	 */
+	size_t encode(uint16_t msg_id, const uint8_t *sample, uint8_t *buffer, hrt_abstime now);
+
+	/**
+	 * Store a sample as reference for the next one. Must be called after the sample has been written to the log.
+	 * @param keyframe true if it was written as regular DATA message
+	 */
+	void written(const uint8_t *sample, bool keyframe, hrt_abstime now);
+
+private:
+	/** @return size of a ULog base type, or 0 if it is not a base type */
+	static size_t base_type_size(const char *type, size_t length);
+
+	bool field_changed(const uint8_t *sample, int field) const;
+
+	uint16_t field_start(int field) const { return field == 0 ? 0 : _field_end[field - 1]; }
+
+	const orb_metadata *_meta;
+	const uint16_t _size;
+
+	uint8_t *_previous{nullptr}; ///< last sample written to the log
+	bool _has_previous{false};
+	hrt_abstime _keyframe_time{0};
+
+	uint16_t _field_end[MAX_FIELDS]; ///< byte offset after each field
+	int _num_fields{1};
+};
+
+} //namespace logger
+} //namespace px4
@@ -140,6 +140,28 @@ public:
 		return 0;
 	}
 
+	/**
+	 * Duration of the ongoing file write [us], 0 if the writer is idle
+	 */
+	hrt_abstime get_write_stall_file(LogType type, hrt_abstime now) const
+	{
+		if (_log_writer_file) { return _log_writer_file->get_write_stall(type, now); }
+
+		return 0;
+	}
+
+	void print_latency_file(LogType type) const
+	{
+		if (_log_writer_file) { _log_writer_file->print_latency(type); }
+	}
+
+	uint64_t get_stream_offset_file(LogType type) const
+	{
+		if (_log_writer_file) { return _log_writer_file->get_stream_offset(type); }
+
+		return 0;
+	}
+
 	pthread_t thread_id_file() const
 	{
 		if (_log_writer_file) { return _log_writer_file->thread_id(); }
@@ -159,6 +181,12 @@ public:
 		if (_log_writer_mavlink) { _log_writer_mavlink->set_need_reliable_transfer(need_reliable && mavlink_backed_too); }
 	}
 
+	/** @see LogWriterMavlink::set_ack_window() */
+	void set_mavlink_ack_window(int window)
+	{
+		if (_log_writer_mavlink) { _log_writer_mavlink->set_ack_window(window); }
+	}
+
 	bool need_reliable_transfer() const
 	{
 		if (_log_writer_file) { return _log_writer_file->need_reliable_transfer(); }
@@ -174,6 +202,13 @@ public:
 		if (_log_writer_file) { _log_writer_file->set_encryption_parameters(algorithm, key_idx, exchange_key_idx); }
 	}
 #endif
+
+#if defined(CONFIG_LOGGER_COMPRESSION)
+	void set_compression(bool enabled)
+	{
+		if (_log_writer_file) { _log_writer_file->set_compression(enabled); }
+	}
+#endif
 private:
 
 	LogWriterFile *_log_writer_file = nullptr;
@@ -63,7 +63,12 @@ LogWriterFile::LogWriterFile(size_t buffer_size)
 	//needs to be larger than the minimum write chunk (300 is somewhat arbitrary)
 	{
 		buffer_size,
+#if defined(CONFIG_LOGGER_COMPRESSION)
+		// the compressed stream needs room for a complete block
+		_min_write_chunk + log_compressed_bound(LOG_COMPRESSION_BLOCK_SIZE),
+#else
 		_min_write_chunk + 300,
+#endif
 		perf_alloc(PC_ELAPSED, "logger_sd_write"), perf_alloc(PC_ELAPSED, "logger_sd_fsync")},
 
 	{
@@ -215,6 +220,7 @@ bool LogWriterFile::start_log(LogType type, const char *filename)
 	}
 
 	if (_buffers[(int)type].start_log(filename)) {
+		_stream_offset[(int)type] = 0;
 
 #if PX4_CRYPTO
 		bool enc_init = init_logfile_encryption(type);
@@ -228,6 +234,32 @@ bool LogWriterFile::start_log(LogType type, const char *filename)
 			return false;
 		}
 
+#endif
+
+#if defined(CONFIG_LOGGER_COMPRESSION)
+
+		if (type == LogType::Full) {
+			lock();
+			_compressing = _compression_enabled;
+
+			if (_compressing) {
+				heatshrink_encoder_reset(&_encoder);
+				_block_uncompressed = 0;
+				_block_compressed = 0;
+
+				ulog_compressed_header_s header{};
+				memcpy(header.magic, "ULogZip", sizeof(header.magic));
+				header.hdr_ver = 1;
+				header.algorithm = ULOG_COMPRESSION_HEATSHRINK;
+				header.window_bits = HEATSHRINK_STATIC_WINDOW_BITS;
+				header.lookahead_bits = HEATSHRINK_STATIC_LOOKAHEAD_BITS;
+				header.block_size = LOG_COMPRESSION_BLOCK_SIZE;
+				_buffers[(int)type].write_no_check(&header, sizeof(header));
+			}
+
+			unlock();
+		}
+
 #endif
 
 		PX4_INFO("Opened %s log file: %s", log_type_str(type), filename);
@@ -273,6 +305,19 @@ int LogWriterFile::hardfault_store_filename(const char *log_file)
 void LogWriterFile::stop_log(LogType type)
 {
 	lock();
+
+#if defined(CONFIG_LOGGER_COMPRESSION)
+
+	if (type == LogType::Full && _compressing) {
+		if (_block_uncompressed > 0) {
+			flush_compressed_block();
+		}
+
+		_compressing = false;
+	}
+
+#endif
+
 	_buffers[(int)type]._should_run = false;
 	unlock();
 	notify();
@@ -293,6 +338,19 @@ int LogWriterFile::thread_start()
 	int ret = pthread_create(&_thread, &thr_attr, &LogWriterFile::run_helper, this);
 	pthread_attr_destroy(&thr_attr);
 
+#if defined(__PX4_POSIX)
+
+	// not a px4 task, so apply a mask set with 'work_queue affinity log_writer_file <mask>' here
+	if (ret == 0) {
+		const uint32_t cpu_mask = px4_task_get_affinity("log_writer_file");
+
+		if (cpu_mask != 0) {
+			px4_thread_set_affinity(_thread, cpu_mask);
+		}
+	}
+
+#endif // __PX4_POSIX
+
 	return ret;
 }
 
@@ -373,11 +431,23 @@ void LogWriterFile::run()
 				void *read_ptr;
 				bool is_part;
 				LogFileBuffer &buffer = _buffers[i];
+
+#if defined(CONFIG_LOGGER_ASYNC_WRITE)
+				buffer.collect_completions(false);
+				buffer.release_completed();
+#endif
+
 				size_t available = buffer.get_read_ptr(&read_ptr, &is_part);
 
 #if defined(PX4_CRYPTO)
-				// Split into min blocksize chunks, so it is good for encrypting in pieces
-				available = (available / _min_blocksize) * _min_blocksize;
+
+				// Split into min blocksize chunks, so it is good for encrypting in pieces. The data is encrypted
+				// in place, so a part that was not written (or queued) the last time is already encrypted.
+				if (available > buffer._bytes_encrypted) {
+					const size_t unencrypted = available - buffer._bytes_encrypted;
+					available = buffer._bytes_encrypted + (unencrypted / _min_blocksize) * _min_blocksize;
+				}
+
 #endif
 
 				/* if sufficient data available or partial read or terminating, write data */
@@ -393,19 +463,23 @@ void LogWriterFile::run()
 					     by the px4 crypto interfaces
 					 */
 
-					size_t out = available;
+					if (_algorithm != CRYPTO_NONE && available > buffer._bytes_encrypted) {
+						uint8_t *encrypt_ptr = (uint8_t *)read_ptr + buffer._bytes_encrypted;
+						const size_t encrypt_size = available - buffer._bytes_encrypted;
+						size_t out = encrypt_size;
 
-					if (_algorithm != CRYPTO_NONE) {
 						_crypto.encrypt_data(
 							_key_idx,
-							(uint8_t *)read_ptr,
-							available,
-							(uint8_t *)read_ptr,
+							encrypt_ptr,
+							encrypt_size,
+							encrypt_ptr,
 							&out);
 
-						if (out != available) {
+						if (out != encrypt_size) {
 							PX4_ERR("Encryption output size mismatch, logfile corrupted");
 						}
+
+						buffer._bytes_encrypted = available;
 					}
 
 #endif
@@ -423,8 +497,21 @@ void LogWriterFile::run()
 					pthread_mutex_lock(&_mtx);
 
 					if (written >= 0) {
+#if defined(PX4_CRYPTO)
+
+						// async writes queue at most MAX_REQUESTS_IN_FLIGHT requests, the rest stays encrypted
+						if (_algorithm != CRYPTO_NONE) {
+							buffer._bytes_encrypted -= written;
+						}
+
+#endif
+#if defined(CONFIG_LOGGER_ASYNC_WRITE)
+						/* the data is queued, the space is released when the requests are finished */
+						buffer.release_completed();
+#else
 						/* subtract bytes written from number in buffer (count -= written) */
 						buffer.mark_read(written);
+#endif
 
 						if (!buffer._should_run && written == static_cast<int>(available) && !is_part) {
 							/* Stop only when all data written */
@@ -507,9 +594,20 @@ int LogWriterFile::write_message(LogType type, void *ptr, size_t size, uint64_t
 
 		uint8_t *uptr = (uint8_t *)ptr;
 
+		// Split into several blocks if the data is longer than the write buffer
+		size_t max_write_size = _buffers[(int)type].buffer_size();
+
+#if defined(CONFIG_LOGGER_COMPRESSION)
+
+		if (type == LogType::Full && _compressing) {
+			// the compressed data must fit into the buffer as well
+			max_write_size = LOG_COMPRESSION_BLOCK_SIZE;
+		}
+
+#endif
+
 		do {
-			// Split into several blocks if the data is longer than the write buffer
-			size_t write_size = math::min(size, _buffers[(int)type].buffer_size());
+			size_t write_size = math::min(size, max_write_size);
 
 			while ((ret = write(type, uptr, write_size, 0)) == -1) {
 				unlock();
@@ -534,6 +632,14 @@ int LogWriterFile::write(LogType type, void *ptr, size_t size, uint64_t dropout_
 		return 0;
 	}
 
+#if defined(CONFIG_LOGGER_COMPRESSION)
+
+	if (type == LogType::Full && _compressing) {
+		return write_compressed(ptr, size, dropout_start);
+	}
+
+#endif
+
 	// Bytes available to write
 	size_t available = _buffers[(int)type].available();
 	size_t dropout_size = 0;
@@ -555,9 +661,110 @@ int LogWriterFile::write(LogType type, void *ptr, size_t size, uint64_t dropout_
 	}
 
 	_buffers[(int)type].write_no_check(ptr, size);
+	_stream_offset[(int)type] += dropout_size + size;
 	return 0;
 }
 
+#if defined(CONFIG_LOGGER_COMPRESSION)
+int LogWriterFile::write_compressed(void *ptr, size_t size, uint64_t dropout_start)
+{
+	LogFileBuffer &buffer = _buffers[(int)LogType::Full];
+	const size_t dropout_size = dropout_start ? sizeof(ulog_message_dropout_s) : 0;
+
+	// Everything accepted must fit into the buffer once compressed, so that the current block can always be
+	// flushed. If it doesn't, flush the block early, as the writer thread might wait for more data.
+	if (log_compressed_bound(_block_uncompressed + dropout_size + size) > buffer.available()) {
+		if (_block_uncompressed > 0) {
+			flush_compressed_block();
+		}
+
+		if (log_compressed_bound(dropout_size + size) > buffer.available()) {
+			// buffer overflow
+			return -1;
+		}
+	}
+
+	if (dropout_start) {
+		//write dropout msg
+		ulog_message_dropout_s dropout_msg;
+		dropout_msg.duration = (uint16_t)(hrt_elapsed_time(&dropout_start) / 1000);
+		compress(&dropout_msg, sizeof(dropout_msg));
+	}
+
+	compress(ptr, size);
+	_stream_offset[(int)LogType::Full] += dropout_size + size;
+
+	// limit the data that is lost on a crash
+	if (_block_uncompressed > 0 && hrt_elapsed_time(&_block_start) > 1_s) {
+		flush_compressed_block();
+	}
+
+	return 0;
+}
+
+void LogWriterFile::compress(void *ptr, size_t size)
+{
+	uint8_t *data = static_cast<uint8_t *>(ptr);
+
+	while (size > 0) {
+		if (_block_uncompressed == 0) {
+			_block_start = hrt_absolute_time();
+		}
+
+		const size_t block_size = math::min(size, LOG_COMPRESSION_BLOCK_SIZE - _block_uncompressed);
+		size_t sunk_total = 0;
+
+		while (sunk_total < block_size) {
+			size_t sunk = 0;
+			heatshrink_encoder_sink(&_encoder, &data[sunk_total], block_size - sunk_total, &sunk);
+			sunk_total += sunk;
+			poll_encoder();
+		}
+
+		_block_uncompressed += block_size;
+		data += block_size;
+		size -= block_size;
+
+		if (_block_uncompressed >= LOG_COMPRESSION_BLOCK_SIZE) {
+			flush_compressed_block();
+		}
+	}
+}
+
+void LogWriterFile::poll_encoder()
+{
+	static constexpr size_t data_offset = sizeof(ulog_compressed_block_s);
+	HSE_poll_res res;
+
+	do {
+		size_t output_size = 0;
+		res = heatshrink_encoder_poll(&_encoder, &_block[data_offset + _block_compressed],
+					      sizeof(_block) - data_offset - _block_compressed, &output_size);
+		_block_compressed += output_size;
+
+	} while (res == HSER_POLL_MORE && _block_compressed < sizeof(_block) - data_offset);
+}
+
+void LogWriterFile::flush_compressed_block()
+{
+	while ((heatshrink_encoder_finish(&_encoder) == HSER_FINISH_MORE)
+	       && (_block_compressed < sizeof(_block) - sizeof(ulog_compressed_block_s))) {
+		poll_encoder();
+	}
+
+	ulog_compressed_block_s header;
+	header.compressed_size = (uint16_t)_block_compressed;
+	header.uncompressed_size = (uint16_t)_block_uncompressed;
+	memcpy(_block, &header, sizeof(header));
+
+	_buffers[(int)LogType::Full].write_no_check(_block, sizeof(header) + _block_compressed);
+
+	heatshrink_encoder_reset(&_encoder);
+	_block_uncompressed = 0;
+	_block_compressed = 0;
+}
+#endif // CONFIG_LOGGER_COMPRESSION
+
 const char *log_type_str(LogType type)
 {
 	switch (type) {
@@ -617,8 +824,15 @@ void LogWriterFile::LogFileBuffer::write_no_check(void *ptr, size_t size)
 
 size_t LogWriterFile::LogFileBuffer::get_read_ptr(void **ptr, bool *is_part)
 {
+#if defined(CONFIG_LOGGER_ASYNC_WRITE)
+	// queued data must stay in the buffer until the request is finished
+	const size_t count = _count - _bytes_in_flight;
+#else
+	const size_t count = _count;
+#endif
+
 	// bytes available to read
-	int read_ptr = _head - _count;
+	int read_ptr = _head - count;
 
 	if (read_ptr < 0) {
 		read_ptr += _buffer_size;
@@ -629,7 +843,7 @@ size_t LogWriterFile::LogFileBuffer::get_read_ptr(void **ptr, bool *is_part)
 	} else {
 		*ptr = &_buffer[read_ptr];
 		*is_part = false;
-		return _count;
+		return count;
 	}
 }
 
@@ -677,24 +891,203 @@ bool LogWriterFile::LogFileBuffer::start_log(const char *filename)
 	_head = 0;
 	_count = 0;
 	_total_written = 0;
+	_write_latency.reset();
+	_fsync_latency.reset();
 
 	_should_run = true;
 
 	return true;
 }
 
-void LogWriterFile::LogFileBuffer::fsync() const
+#if defined(CONFIG_LOGGER_ASYNC_WRITE)
+void LogWriterFile::LogFileBuffer::fsync()
+{
+	collect_completions(false);
+
+	// an fsync covers all writes queued before it, so there is no need for more than one
+	if (_fsync_in_flight) {
+		return;
+	}
+
+	_fsync_request.cb = {};
+	_fsync_request.cb.aio_fildes = _fd;
+	_fsync_request.start = hrt_absolute_time();
+
+	if (aio_fsync(O_SYNC, &_fsync_request.cb) == 0) {
+		_fsync_in_flight = true;
+
+	} else {
+		// fall back to a blocking fsync
+		perf_begin(_perf_fsync);
+		::fsync(_fd);
+		perf_end(_perf_fsync);
+		_fsync_latency.add(hrt_elapsed_time(&_fsync_request.start));
+	}
+}
+
+ssize_t LogWriterFile::LogFileBuffer::write_to_file(const void *buffer, size_t size, bool call_fsync)
+{
+	collect_completions(false);
+
+	if (_async_errno != 0) {
+		errno = _async_errno;
+		return -1;
+	}
+
+	if (_requests_in_flight == MAX_REQUESTS_IN_FLIGHT) {
+		// wait for the oldest request to make room
+		const struct aiocb *oldest[1] = {&_requests[_request_head].cb};
+		aio_suspend(oldest, 1, nullptr);
+		collect_completions(false);
+	}
+
+	if (_file_offset < 0) {
+		// data might have been written with ::write() before (e.g. the encryption key)
+		_file_offset = lseek(_fd, 0, SEEK_CUR);
+
+		if (_file_offset < 0) {
+			return -1;
+		}
+	}
+
+	const uint8_t *data = static_cast<const uint8_t *>(buffer);
+	size_t queued = 0;
+
+	while (queued < size && _requests_in_flight < MAX_REQUESTS_IN_FLIGHT) {
+		AsyncRequest &request = _requests[(_request_head + _requests_in_flight) % MAX_REQUESTS_IN_FLIGHT];
+		const size_t request_size = math::min(size - queued, MAX_REQUEST_SIZE);
+
+		request.cb = {};
+		request.cb.aio_fildes = _fd;
+		request.cb.aio_buf = const_cast<uint8_t *>(data + queued);
+		request.cb.aio_nbytes = request_size;
+		request.cb.aio_offset = _file_offset;
+		request.start = hrt_absolute_time();
+
+		if (aio_write(&request.cb) != 0) {
+			if (queued == 0 && _requests_in_flight == 0) {
+				return -1;
+			}
+
+			// retry with the next call, when some requests are finished
+			break;
+		}
+
+		++_requests_in_flight;
+		_file_offset += request_size;
+		queued += request_size;
+	}
+
+	_bytes_in_flight += queued;
+
+	if (call_fsync) {
+		fsync();
+	}
+
+	update_write_start();
+	return queued;
+}
+
+bool LogWriterFile::LogFileBuffer::request_finished(AsyncRequest &request, FileLatencyHistogram &latency,
+		perf_counter_t perf)
+{
+	if (aio_error(&request.cb) == EINPROGRESS) {
+		return false;
+	}
+
+	const hrt_abstime elapsed = hrt_elapsed_time(&request.start);
+	latency.add(elapsed);
+	perf_set_elapsed(perf, elapsed);
+	return true;
+}
+
+void LogWriterFile::LogFileBuffer::collect_completions(bool wait)
 {
+	while (_requests_in_flight > 0) {
+		AsyncRequest &request = _requests[_request_head];
+
+		if (wait) {
+			const struct aiocb *list[1] = {&request.cb};
+
+			while (aio_error(&request.cb) == EINPROGRESS) {
+				aio_suspend(list, 1, nullptr);
+			}
+		}
+
+		if (!request_finished(request, _write_latency, _perf_write)) {
+			break;
+		}
+
+		const ssize_t ret = aio_return(&request.cb);
+
+		if (ret < 0) {
+			_async_errno = aio_error(&request.cb);
+
+		} else if ((size_t)ret != request.cb.aio_nbytes) {
+			_async_errno = ENOSPC;
+		}
+
+		if (ret > 0) {
+			_total_written += ret;
+		}
+
+		// failed data is released as well: the file is closed after an error anyway
+		_bytes_completed += request.cb.aio_nbytes;
+		_request_head = (_request_head + 1) % MAX_REQUESTS_IN_FLIGHT;
+		--_requests_in_flight;
+	}
+
+	if (_fsync_in_flight) {
+		if (wait) {
+			const struct aiocb *list[1] = {&_fsync_request.cb};
+
+			while (aio_error(&_fsync_request.cb) == EINPROGRESS) {
+				aio_suspend(list, 1, nullptr);
+			}
+		}
+
+		if (request_finished(_fsync_request, _fsync_latency, _perf_fsync)) {
+			aio_return(&_fsync_request.cb);
+			_fsync_in_flight = false;
+		}
+	}
+
+	update_write_start();
+}
+
+void LogWriterFile::LogFileBuffer::update_write_start()
+{
+	hrt_abstime start = _requests_in_flight > 0 ? _requests[_request_head].start : 0;
+
+	if (_fsync_in_flight && (start == 0 || _fsync_request.start < start)) {
+		start = _fsync_request.start;
+	}
+
+	_write_start.store(start);
+}
+
+#else
+
+void LogWriterFile::LogFileBuffer::fsync()
+{
+	const hrt_abstime start = hrt_absolute_time();
+	_write_start.store(start);
 	perf_begin(_perf_fsync);
 	::fsync(_fd);
 	perf_end(_perf_fsync);
+	_write_start.store(0);
+	_fsync_latency.add(hrt_elapsed_time(&start));
 }
 
-ssize_t LogWriterFile::LogFileBuffer::write_to_file(const void *buffer, size_t size, bool call_fsync) const
+ssize_t LogWriterFile::LogFileBuffer::write_to_file(const void *buffer, size_t size, bool call_fsync)
 {
+	const hrt_abstime start = hrt_absolute_time();
+	_write_start.store(start);
 	perf_begin(_perf_write);
 	ssize_t ret = ::write(_fd, buffer, size);
 	perf_end(_perf_write);
+	_write_start.store(0);
+	_write_latency.add(hrt_elapsed_time(&start));
 
 	if (call_fsync) {
 		fsync();
@@ -702,9 +1095,39 @@ ssize_t LogWriterFile::LogFileBuffer::write_to_file(const void *buffer, size_t s
 
 	return ret;
 }
+#endif // CONFIG_LOGGER_ASYNC_WRITE
+
+void LogWriterFile::LogFileBuffer::print_latency() const
+{
+	PX4_INFO("Write latency: p50: %" PRIu32 " us, p90: %" PRIu32 " us, p99: %" PRIu32 " us, max: %" PRIu32 " us (%" PRIu32
+		 " requests)", _write_latency.percentile(50), _write_latency.percentile(90), _write_latency.percentile(99),
+		 _write_latency.max(), _write_latency.count());
+	PX4_INFO("fsync latency: p50: %" PRIu32 " us, p90: %" PRIu32 " us, p99: %" PRIu32 " us, max: %" PRIu32 " us (%" PRIu32
+		 " requests)", _fsync_latency.percentile(50), _fsync_latency.percentile(90), _fsync_latency.percentile(99),
+		 _fsync_latency.max(), _fsync_latency.count());
+#if defined(CONFIG_LOGGER_ASYNC_WRITE)
+	PX4_INFO("Async writes in flight: %i / %i (%zu B), fsync in flight: %s", _requests_in_flight, MAX_REQUESTS_IN_FLIGHT,
+		 _bytes_in_flight, _fsync_in_flight ? "yes" : "no");
+#endif
+}
 
 void LogWriterFile::LogFileBuffer::close_file()
 {
+#if defined(CONFIG_LOGGER_ASYNC_WRITE)
+
+	if (_fd >= 0) {
+		// the writer has stopped, so the buffer can be released without locking
+		collect_completions(true);
+		release_completed();
+
+		if (_async_errno != 0) {
+			PX4_ERR("async write failed (%i)", _async_errno);
+			_had_write_error.store(true);
+		}
+	}
+
+#endif
+
 	if (_fd >= 0) {
 		int res = close(_fd);
 
@@ -722,6 +1145,18 @@ void LogWriterFile::LogFileBuffer::reset()
 	_head = 0;
 	_count = 0;
 	_fd = -1;
+#if defined(PX4_CRYPTO)
+	_bytes_encrypted = 0;
+#endif
+#if defined(CONFIG_LOGGER_ASYNC_WRITE)
+	_request_head = 0;
+	_requests_in_flight = 0;
+	_fsync_in_flight = false;
+	_file_offset = -1;
+	_bytes_in_flight = 0;
+	_bytes_completed = 0;
+	_async_errno = 0;
+#endif
 }
 
 }
@@ -39,8 +39,19 @@
 #include <pthread.h>
 #include <drivers/drv_hrt.h>
 #include <perf/perf_counter.h>
+#include <perf/LatencyHistogram.hpp>
 #include <px4_platform_common/crypto.h>
 
+#include "messages.h"
+
+#if defined(CONFIG_LOGGER_COMPRESSION)
+#include <lib/heatshrink/heatshrink/heatshrink_encoder.h>
+#endif
+
+#if defined(CONFIG_LOGGER_ASYNC_WRITE)
+#include <aio.h>
+#endif
+
 namespace px4
 {
 namespace logger
@@ -59,6 +70,23 @@ enum class LogType {
 
 const char *log_type_str(LogType type);
 
+#if defined(CONFIG_LOGGER_COMPRESSION)
+/* uncompressed size of a compressed block, the heatshrink window is much smaller anyway */
+static constexpr size_t LOG_COMPRESSION_BLOCK_SIZE = 2048;
+
+/**
+ * Upper bound of the compressed size of size bytes, including the block headers.
+ * heatshrink needs at most 9 bits per byte.
+ */
+static constexpr size_t log_compressed_bound(size_t size)
+{
+	return size + size / 8 + (size / LOG_COMPRESSION_BLOCK_SIZE + 1) * (sizeof(ulog_compressed_block_s) + 2);
+}
+#endif
+
+/** file write and fsync request latencies, up to 2^23 us (~8 s) */
+using FileLatencyHistogram = LatencyHistogram<24>;
+
 /**
  * @class LogWriterFile
  * Writes logging data to a file
@@ -118,6 +146,19 @@ public:
 		return _buffers[(int)type].count();
 	}
 
+	hrt_abstime get_write_stall(LogType type, hrt_abstime now) const
+	{
+		return _buffers[(int)type].write_stall(now);
+	}
+
+	/**
+	 * Offset of the next message in the ULog stream (before compression and encryption), requires lock()
+	 */
+	uint64_t get_stream_offset(LogType type) const
+	{
+		return _stream_offset[(int)type];
+	}
+
 	void set_need_reliable_transfer(bool need_reliable)
 	{
 		if (!need_reliable && _need_reliable_transfer) {
@@ -134,6 +175,11 @@ public:
 
 	bool had_write_error() const { return _buffers[(int)LogType::Full]._had_write_error.load(); }
 
+	/**
+	 * print the write and fsync latencies of a log file
+	 */
+	void print_latency(LogType type) const { _buffers[(int)type].print_latency(); }
+
 	pthread_t thread_id() const { return _thread; }
 
 #if defined(PX4_CRYPTO)
@@ -145,6 +191,13 @@ public:
 	}
 #endif
 
+#if defined(CONFIG_LOGGER_COMPRESSION)
+	/**
+	 * Compress the full log of the next start_log() call.
+	 */
+	void set_compression(bool enabled) { _compression_enabled = enabled; }
+#endif
+
 private:
 	static void *run_helper(void *);
 
@@ -166,6 +219,23 @@ private:
 	/* 512 didn't seem to work properly, 4096 should match the FAT cluster size */
 	static constexpr size_t	_min_write_chunk = 4096;
 
+#if defined(CONFIG_LOGGER_COMPRESSION)
+	/**
+	 * write w/o waiting/blocking into the compressed full log
+	 */
+	int write_compressed(void *ptr, size_t size, uint64_t dropout_start);
+
+	void compress(void *ptr, size_t size);
+
+	void poll_encoder();
+
+	/**
+	 * Finish the current block and move it into the full log buffer, which must have
+	 * log_compressed_bound() space for it.
+	 */
+	void flush_compressed_block();
+#endif
+
 	class LogFileBuffer
 	{
 	public:
@@ -191,18 +261,56 @@ private:
 
 		int fd() const { return _fd; }
 
-		inline ssize_t write_to_file(const void *buffer, size_t size, bool call_fsync) const;
+		/**
+		 * Write to the file. With CONFIG_LOGGER_ASYNC_WRITE, this only queues the data (possibly not all of it)
+		 * and the space is released by release_completed() once the requests finished.
+		 * @return number of bytes written (or queued), -1 on error
+		 */
+		inline ssize_t write_to_file(const void *buffer, size_t size, bool call_fsync);
 
-		inline void fsync() const;
+		inline void fsync();
 
 		void mark_read(size_t n) { _count -= n; _total_written += n; }
 
+#if defined(CONFIG_LOGGER_ASYNC_WRITE)
+		/**
+		 * Collect finished requests (in the order they were queued).
+		 * @param wait wait until all queued requests are finished
+		 */
+		void collect_completions(bool wait);
+
+		/**
+		 * Release the buffer space of collected requests, requires _mtx to be locked
+		 */
+		void release_completed()
+		{
+			_count -= _bytes_completed;
+			_bytes_in_flight -= _bytes_completed;
+			_bytes_completed = 0;
+		}
+#endif
+
+		/**
+		 * Duration of the ongoing file write or fsync (the oldest one with async writes), 0 if there is none.
+		 * Can be called from any thread.
+		 */
+		hrt_abstime write_stall(hrt_abstime now) const
+		{
+			const hrt_abstime start = _write_start.load();
+			return (start != 0 && now > start) ? now - start : 0;
+		}
+
+		void print_latency() const;
+
 		size_t total_written() const { return _total_written; }
 		size_t buffer_size() const { return _buffer_size; }
 		size_t count() const { return _count; }
 
 		bool _should_run = false;
 		px4::atomic_bool _had_write_error{false};
+#if defined(PX4_CRYPTO)
+		size_t _bytes_encrypted = 0; ///< bytes at the read pointer that are encrypted in place but not written yet
+#endif
 	private:
 		size_t _buffer_size;
 		const size_t _buffer_size_min;
@@ -213,9 +321,39 @@ private:
 		size_t _total_written = 0;
 		perf_counter_t _perf_write;
 		perf_counter_t _perf_fsync;
+		FileLatencyHistogram _write_latency;
+		FileLatencyHistogram _fsync_latency;
+		px4::atomic<hrt_abstime> _write_start{0}; ///< start of the ongoing write or fsync, 0 if there is none
+
+#if defined(CONFIG_LOGGER_ASYNC_WRITE)
+		static constexpr int MAX_REQUESTS_IN_FLIGHT = 4;
+		static constexpr size_t MAX_REQUEST_SIZE = 4 * _min_write_chunk;
+
+		struct AsyncRequest {
+			struct aiocb cb;
+			hrt_abstime start;
+		};
+
+		/** @return true if the request is finished, and records its latency */
+		bool request_finished(AsyncRequest &request, FileLatencyHistogram &latency, perf_counter_t perf);
+
+		/** set _write_start to the start of the oldest request in flight */
+		void update_write_start();
+
+		AsyncRequest _requests[MAX_REQUESTS_IN_FLIGHT] {}; ///< ring of write requests
+		int _request_head{0}; ///< oldest queued request
+		int _requests_in_flight{0};
+		AsyncRequest _fsync_request{};
+		bool _fsync_in_flight{false};
+		off_t _file_offset{-1}; ///< file offset of the next request, -1 until the first one
+		size_t _bytes_in_flight{0}; ///< bytes at the read end of _buffer that are queued or not yet released
+		size_t _bytes_completed{0}; ///< finished bytes that are not yet released
+		int _async_errno{0}; ///< error of a finished request
+#endif
 	};
 
 	LogFileBuffer _buffers[(int)LogType::Count];
+	uint64_t _stream_offset[(int)LogType::Count] {}; ///< bytes written by write() to the current log file
 
 	px4::atomic_bool	_exit_thread{false};
 	bool			_need_reliable_transfer{false};
@@ -223,6 +361,15 @@ private:
 	pthread_mutex_t		_mtx;
 	pthread_cond_t		_cv;
 	pthread_t _thread = 0;
+#if defined(CONFIG_LOGGER_COMPRESSION)
+	bool _compression_enabled{false};
+	bool _compressing{false}; ///< the current full log is compressed
+	heatshrink_encoder _encoder;
+	size_t _block_uncompressed{0};
+	size_t _block_compressed{0};
+	hrt_abstime _block_start{0};
+	uint8_t _block[log_compressed_bound(LOG_COMPRESSION_BLOCK_SIZE)]; ///< block header and compressed data
+#endif
 #if defined(PX4_CRYPTO)
 	bool init_logfile_encryption(const LogType type);
 	PX4Crypto _crypto;
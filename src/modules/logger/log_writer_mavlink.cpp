@@ -68,13 +68,19 @@ void LogWriterMavlink::start_log()
 		_ulog_stream_ack_sub = orb_subscribe(ORB_ID(ulog_stream_ack));
 	}
 
-	// make sure we don't get any stale ack's by doing an orb_copy
+	// make sure we don't get any stale ack's by reading all queued ones
 	ulog_stream_ack_s ack;
-	orb_copy(ORB_ID(ulog_stream_ack), _ulog_stream_ack_sub, &ack);
+	bool updated = true;
+
+	while (orb_check(_ulog_stream_ack_sub, &updated) == 0 && updated) {
+		orb_copy(ORB_ID(ulog_stream_ack), _ulog_stream_ack_sub, &ack);
+	}
 
 	_ulog_stream_data.msg_sequence = 0;
 	_ulog_stream_data.length = 0;
 	_ulog_stream_data.first_message_offset = 0;
+	_oldest_unacked_sequence = 0;
+	_acked_mask = 0;
 
 	_is_started = true;
 }
@@ -82,6 +88,8 @@ void LogWriterMavlink::start_log()
 void LogWriterMavlink::stop_log()
 {
 	_ulog_stream_data.length = 0;
+	_oldest_unacked_sequence = _ulog_stream_data.msg_sequence;
+	_acked_mask = 0;
 	_is_started = false;
 }
 
@@ -122,11 +130,21 @@ void LogWriterMavlink::set_need_reliable_transfer(bool need_reliable)
 			// make sure to send previous data using reliable transfer
 			publish_message();
 		}
+
+		// the reliable section must be complete before continuing with unacked messages
+		if (is_started()) {
+			wait_for_acks(0);
+		}
 	}
 
 	_need_reliable_transfer = need_reliable;
 }
 
+void LogWriterMavlink::set_ack_window(int window)
+{
+	_ack_window = math::constrain(window, 1, (int)ulog_stream_ack_s::ACK_WINDOW_MAX);
+}
+
 int LogWriterMavlink::publish_message()
 {
 	_ulog_stream_data.timestamp = hrt_absolute_time();
@@ -138,51 +156,69 @@ int LogWriterMavlink::publish_message()
 
 	_ulog_stream_pub.publish(_ulog_stream_data);
 
-	if (_need_reliable_transfer) {
-		// we need to wait for an ack. Note that this blocks the main logger thread, so if a file logging
-		// is already running, it will miss samples.
-		px4_pollfd_struct_t fds[1];
-		fds[0].fd = _ulog_stream_ack_sub;
-		fds[0].events = POLLIN;
-		bool got_ack = false;
-		const int timeout_ms = ulog_stream_ack_s::ACK_TIMEOUT * ulog_stream_ack_s::ACK_MAX_TRIES;
-
-		hrt_abstime started = hrt_absolute_time();
+	_ulog_stream_data.msg_sequence++;
+	_ulog_stream_data.length = 0;
+	_ulog_stream_data.first_message_offset = 255;
 
-		do {
-			int ret = px4_poll(fds, sizeof(fds) / sizeof(fds[0]), timeout_ms);
+	if (!_need_reliable_transfer) {
+		// nothing is in flight (the reliable section waits for all acks before it ends)
+		_oldest_unacked_sequence = _ulog_stream_data.msg_sequence;
+		return 0;
+	}
 
-			if (ret <= 0) {
-				break;
-			}
+	// make room for the next message
+	return wait_for_acks(_ack_window - 1);
+}
 
-			if (fds[0].revents & POLLIN) {
-				ulog_stream_ack_s ack;
-				orb_copy(ORB_ID(ulog_stream_ack), _ulog_stream_ack_sub, &ack);
+int LogWriterMavlink::wait_for_acks(int max_unacked)
+{
+	// Note that this blocks the main logger thread, so if a file logging is already running, it will miss samples.
+	px4_pollfd_struct_t fds[1];
+	fds[0].fd = _ulog_stream_ack_sub;
+	fds[0].events = POLLIN;
+	const int timeout_ms = ulog_stream_ack_s::ACK_TIMEOUT * ulog_stream_ack_s::ACK_MAX_TRIES;
 
-				if (ack.msg_sequence == _ulog_stream_data.msg_sequence) {
-					got_ack = true;
-				}
+	hrt_abstime started = hrt_absolute_time();
 
-			} else {
-				break;
-			}
-		} while (!got_ack && hrt_elapsed_time(&started) / 1000 < timeout_ms);
+	while (num_unacked() > max_unacked && hrt_elapsed_time(&started) / 1000 < timeout_ms) {
+		int ret = px4_poll(fds, sizeof(fds) / sizeof(fds[0]), timeout_ms);
 
-		if (!got_ack) {
-			PX4_ERR("Ack timeout. Stopping mavlink log");
-			stop_log();
-			return -2;
+		if (ret <= 0 || !(fds[0].revents & POLLIN)) {
+			break;
 		}
 
-		PX4_DEBUG("got ack in %i ms", (int)(hrt_elapsed_time(&started) / 1000));
+		ulog_stream_ack_s ack;
+		orb_copy(ORB_ID(ulog_stream_ack), _ulog_stream_ack_sub, &ack);
+		handle_ack(ack.msg_sequence);
 	}
 
-	_ulog_stream_data.msg_sequence++;
-	_ulog_stream_data.length = 0;
-	_ulog_stream_data.first_message_offset = 255;
+	if (num_unacked() > max_unacked) {
+		PX4_ERR("Ack timeout. Stopping mavlink log");
+		stop_log();
+		return -2;
+	}
+
+	PX4_DEBUG("got acks in %i ms", (int)(hrt_elapsed_time(&started) / 1000));
 	return 0;
 }
 
+void LogWriterMavlink::handle_ack(uint16_t sequence)
+{
+	const uint16_t offset = sequence - _oldest_unacked_sequence;
+
+	if (offset >= num_unacked()) {
+		// duplicate or stale ack
+		return;
+	}
+
+	// acks can arrive out of order, the window only moves on when the oldest message is acked
+	_acked_mask |= 1u << offset;
+
+	while (_acked_mask & 1u) {
+		_acked_mask >>= 1;
+		++_oldest_unacked_sequence;
+	}
+}
+
 }
 }
@@ -71,16 +71,38 @@ public:
 		return _need_reliable_transfer;
 	}
 
+	/**
+	 * Set the number of reliable messages that can be in flight without an ack.
+	 * With 1, each message waits for its ack (which all receivers support), larger windows require
+	 * a receiver that can reorder retransmitted messages.
+	 */
+	void set_ack_window(int window);
+
 private:
 
 	/** publish message, wait for ack if needed & reset message */
 	int publish_message();
 
+	/**
+	 * Wait until at most max_unacked reliable messages are in flight.
+	 * @return 0 on success, -2 on ack timeout (the log is stopped)
+	 */
+	int wait_for_acks(int max_unacked);
+
+	void handle_ack(uint16_t sequence);
+
+	/** number of published reliable messages without an ack */
+	int num_unacked() const { return (uint16_t)(_ulog_stream_data.msg_sequence - _oldest_unacked_sequence); }
+
 	ulog_stream_s _ulog_stream_data{};
 	uORB::Publication<ulog_stream_s> _ulog_stream_pub{ORB_ID(ulog_stream)};
 	int _ulog_stream_ack_sub{-1};
 	bool _need_reliable_transfer{false};
 	bool _is_started{false};
+
+	int _ack_window{1};
+	uint16_t _oldest_unacked_sequence{0};
+	uint32_t _acked_mask{0}; ///< acks received out of order, bit i for sequence _oldest_unacked_sequence + i
 };
 
 }
@@ -148,6 +148,7 @@ void LoggedTopics::add_default_topics()
 	add_topic("vehicle_status");
 	add_optional_topic("vtol_vehicle_status", 200);
 	add_topic("wind", 1000);
+	add_optional_topic("work_item_latency");
 	add_topic("fixed_wing_lateral_setpoint");
 	add_topic("fixed_wing_longitudinal_setpoint");
 	add_topic("longitudinal_control_configuration");
@@ -471,9 +472,80 @@ bool LoggedTopics::add_topic(const orb_metadata *topic, uint16_t interval_ms, ui
 	sub.interval_ms = interval_ms;
 	sub.instance = instance;
 	sub.id = static_cast<ORB_ID>(topic->o_id);
+	sub.priority = priority_for(sub.id);
 	return true;
 }
 
+TopicPriority LoggedTopics::priority_for(ORB_ID id)
+{
+	switch (id) {
+	// estimator and control
+	case ORB_ID::actuator_motors:
+	case ORB_ID::actuator_outputs:
+	case ORB_ID::actuator_servos:
+	case ORB_ID::battery_status:
+	case ORB_ID::ekf2_timestamps:
+	case ORB_ID::estimator_innovations:
+	case ORB_ID::estimator_selector_status:
+	case ORB_ID::estimator_sensor_bias:
+	case ORB_ID::estimator_states:
+	case ORB_ID::estimator_status:
+	case ORB_ID::estimator_status_flags:
+	case ORB_ID::failsafe_flags:
+	case ORB_ID::rate_ctrl_status:
+	case ORB_ID::sensor_combined:
+	case ORB_ID::sensor_gps:
+	case ORB_ID::sensor_selection:
+	case ORB_ID::trajectory_setpoint:
+	case ORB_ID::vehicle_acceleration:
+	case ORB_ID::vehicle_air_data:
+	case ORB_ID::vehicle_angular_velocity:
+	case ORB_ID::vehicle_attitude:
+	case ORB_ID::vehicle_attitude_setpoint:
+	case ORB_ID::vehicle_control_mode:
+	case ORB_ID::vehicle_global_position:
+	case ORB_ID::vehicle_gps_position:
+	case ORB_ID::vehicle_imu:
+	case ORB_ID::vehicle_land_detected:
+	case ORB_ID::vehicle_local_position:
+	case ORB_ID::vehicle_local_position_setpoint:
+	case ORB_ID::vehicle_magnetometer:
+	case ORB_ID::vehicle_odometry:
+	case ORB_ID::vehicle_rates_setpoint:
+	case ORB_ID::vehicle_status:
+	case ORB_ID::vehicle_thrust_setpoint:
+	case ORB_ID::vehicle_torque_setpoint:
+	case ORB_ID::vehicle_visual_odometry:
+		return TopicPriority::Critical;
+
+	// debug, diagnostics and raw sensor data
+	case ORB_ID::cpuload:
+	case ORB_ID::debug_array:
+	case ORB_ID::debug_key_value:
+	case ORB_ID::debug_value:
+	case ORB_ID::debug_vect:
+	case ORB_ID::gps_dump:
+	case ORB_ID::mag_worker_data:
+	case ORB_ID::mavlink_tunnel:
+	case ORB_ID::radio_status:
+	case ORB_ID::satellite_info:
+	case ORB_ID::sensor_accel:
+	case ORB_ID::sensor_accel_fifo:
+	case ORB_ID::sensor_baro:
+	case ORB_ID::sensor_gyro:
+	case ORB_ID::sensor_gyro_fft:
+	case ORB_ID::sensor_gyro_fifo:
+	case ORB_ID::sensor_mag:
+	case ORB_ID::sensor_preflight_mag:
+	case ORB_ID::telemetry_status:
+	case ORB_ID::vehicle_imu_status:
+		return TopicPriority::Low;
+
+	default:
+		return TopicPriority::Normal;
+	}
+}
+
 bool LoggedTopics::add_topic(const char *name, uint16_t interval_ms, uint8_t instance, bool optional)
 {
 	interval_ms /= _rate_factor;
@@ -64,6 +64,15 @@ enum class MissionLogType : int32_t {
 	Geotagging =             2
 };
 
+/**
+ * Importance of a logged topic, used to decide what to reduce first when the log cannot be written fast enough
+ */
+enum class TopicPriority : uint8_t {
+	Low = 0,        ///< debug and raw sensor data
+	Normal,
+	Critical        ///< estimator and control data, never reduced
+};
+
 inline bool operator&(SDLogProfileMask a, SDLogProfileMask b)
 {
 	return static_cast<int32_t>(a) & static_cast<int32_t>(b);
@@ -83,6 +92,7 @@ public:
 	struct RequestedSubscription {
 		uint16_t interval_ms;
 		uint8_t instance;
+		TopicPriority priority{TopicPriority::Normal};
 		ORB_ID id{ORB_ID::INVALID};
 	};
 	struct RequestedSubscriptionArray {
@@ -109,6 +119,11 @@ public:
 
 	void set_rate_factor(float rate_factor) { _rate_factor = rate_factor; }
 
+	/**
+	 * Get the priority class of a topic
+	 */
+	static TopicPriority priority_for(ORB_ID id);
+
 private:
 
 	/**
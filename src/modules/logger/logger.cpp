@@ -244,6 +244,17 @@ void Logger::print_statistics(LogType type)
 
 	PX4_INFO("Since last status: dropouts: %zu (max len: %.3f s), max used buffer: %zu / %zu B",
 		 stats.write_dropouts, (double)stats.max_dropout_duration, stats.high_water, _writer.get_buffer_size_file(type));
+#if defined(CONFIG_LOGGER_BACKPRESSURE)
+
+	if (type == LogType::Full) {
+		PX4_INFO("Adaptive rate: level %i (max %i), not logged samples: %zu", _backpressure.level(),
+			 stats.max_backpressure_level, stats.shed_messages);
+		stats.max_backpressure_level = _backpressure.level();
+		stats.shed_messages = 0;
+	}
+
+#endif
+	_writer.print_latency_file(type);
 	stats.high_water = 0;
 	stats.write_dropouts = 0;
 	stats.max_dropout_duration = 0.f;
@@ -415,6 +426,20 @@ Logger::~Logger()
 	}
 
 	delete[](_msg_buffer);
+
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+	delete[](_delta_buffer);
+
+	for (int i = 0; i < _num_subscriptions; ++i) {
+		delete _subscriptions[i].delta_encoder;
+	}
+
+#endif
+
+#if defined(CONFIG_LOGGER_INDEX)
+	delete[](_index_buffer);
+#endif
+
 	delete[](_subscriptions);
 }
 
@@ -464,10 +489,20 @@ bool Logger::copy_if_updated(int sub_idx, void *buffer, bool try_to_subscribe)
 
 	} else if (try_to_subscribe) {
 		if (sub.subscribe()) {
-			write_add_logged_msg(LogType::Full, sub);
+#if defined(CONFIG_LOGGER_EVENT_DRIVEN)
+			register_updated_flag(sub_idx);
+#endif
+#if defined(CONFIG_LOGGER_LAZY_FORMATS)
+			_definitions_pending = true;
+#endif
 
-			if (sub_idx < _num_mission_subs) {
-				write_add_logged_msg(LogType::Mission, sub);
+			// with lazy formats, the subscription is written together with the first sample
+			if (!lazy_formats()) {
+				write_add_logged_msg(LogType::Full, sub);
+
+				if (sub_idx < _num_mission_subs) {
+					write_add_logged_msg(LogType::Mission, sub);
+				}
 			}
 
 			// copy first data
@@ -478,6 +513,100 @@ bool Logger::copy_if_updated(int sub_idx, void *buffer, bool try_to_subscribe)
 	return updated;
 }
 
+void Logger::write_subscription_data(int sub_idx, bool try_to_subscribe, hrt_abstime loop_time, uint32_t &total_bytes)
+{
+	LoggerSubscription &sub = _subscriptions[sub_idx];
+
+	/* if this topic has been updated, copy the new data into the message buffer
+	 * and write a message to the log
+	 */
+	if (copy_if_updated(sub_idx, _msg_buffer + sizeof(ulog_message_data_s), try_to_subscribe)) {
+#if defined(CONFIG_LOGGER_LAZY_FORMATS)
+
+		if (_lazy_formats) {
+			// assigns the msg_id on first use
+			write_definitions(LogType::Full, sub_idx);
+		}
+
+#endif
+
+		// each message consists of a header followed by an orb data object
+		const size_t msg_size = sizeof(ulog_message_data_s) + sub.get_topic()->o_size_no_padding;
+		const uint16_t write_msg_size = static_cast<uint16_t>(msg_size - ULOG_MSG_HEADER_LEN);
+		const uint16_t write_msg_id = sub.msg_id;
+
+		//write one byte after another (necessary because of alignment)
+		_msg_buffer[0] = (uint8_t)write_msg_size;
+		_msg_buffer[1] = (uint8_t)(write_msg_size >> 8);
+		_msg_buffer[2] = static_cast<uint8_t>(ULogMessageType::DATA);
+		_msg_buffer[3] = (uint8_t)write_msg_id;
+		_msg_buffer[4] = (uint8_t)(write_msg_id >> 8);
+
+		// PX4_INFO("topic: %s, size = %zu, out_size = %zu", sub.get_topic()->o_name, sub.get_topic()->o_size, msg_size);
+
+		bool write_full_log = true;
+
+#if defined(CONFIG_LOGGER_BACKPRESSURE)
+
+		if (_backpressure.level() > 0 && BackpressureController::shed(sub.priority,
+				_writer.get_buffer_fill_count_file(LogType::Full), _writer.get_buffer_size_file(LogType::Full))) {
+			// keep the remaining buffer space for the higher-priority topics
+			++_statistics[(int)LogType::Full].shed_messages;
+			write_full_log = false;
+		}
+
+#endif
+
+		// full log
+		if (write_full_log && write_data_message(sub, msg_size, loop_time)) {
+
+#ifdef DBGPRINT
+			total_bytes += msg_size;
+#endif /* DBGPRINT */
+		}
+
+		// mission log
+		if (sub_idx < _num_mission_subs) {
+			if (_writer.is_started(LogType::Mission)) {
+				if (_mission_subscriptions[sub_idx].next_write_time < (loop_time / 100000)) {
+					unsigned delta_time = _mission_subscriptions[sub_idx].min_delta_ms;
+
+					if (delta_time > 0) {
+						_mission_subscriptions[sub_idx].next_write_time = (loop_time / 100000) + delta_time / 100;
+					}
+
+#if defined(CONFIG_LOGGER_LAZY_FORMATS)
+
+					if (_lazy_formats) {
+						write_definitions(LogType::Mission, sub_idx);
+					}
+
+#endif
+					write_message(LogType::Mission, _msg_buffer, msg_size);
+				}
+			}
+		}
+	}
+
+#if defined(CONFIG_LOGGER_EVENT_DRIVEN)
+
+	if (sub.get_interval_us() > 0 && sub.valid() && sub.pending()) {
+		// rate limited: check again in the next iteration
+		_updated_flags[sub_idx / 32].fetch_or(1u << (sub_idx % 32));
+	}
+
+#endif
+}
+
+#if defined(CONFIG_LOGGER_EVENT_DRIVEN)
+void Logger::register_updated_flag(int sub_idx)
+{
+	if (_subscriptions[sub_idx].valid()) {
+		_subscriptions[sub_idx].register_updated_flag(&_updated_flags[sub_idx / 32], 1u << (sub_idx % 32));
+	}
+}
+#endif
+
 const char *Logger::configured_backend_mode() const
 {
 	switch (_writer.backend()) {
@@ -561,7 +690,15 @@ bool Logger::initialize_topics()
 		for (int i = 0; i < logged_topics.subscriptions().count; ++i) {
 			const LoggedTopics::RequestedSubscription &sub = logged_topics.subscriptions().sub[i];
 			_subscriptions[i] = LoggerSubscription(sub.id, sub.interval_ms, sub.instance);
+#if defined(CONFIG_LOGGER_BACKPRESSURE)
+			_subscriptions[i].priority = sub.priority;
+			_subscriptions[i].configured_interval_us = _subscriptions[i].get_interval_us();
+#endif
+
 			_subscriptions[i].subscribe();
+#if defined(CONFIG_LOGGER_EVENT_DRIVEN)
+			register_updated_flag(i);
+#endif
 		}
 	}
 
@@ -637,6 +774,17 @@ void Logger::run()
 		}
 	}
 
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+	initialize_delta_encoders();
+#endif
+
+#if defined(CONFIG_LOGGER_INDEX)
+	initialize_index();
+#endif
+
+#if defined(CONFIG_LOGGER_LAZY_FORMATS)
+	_lazy_formats = _param_sdlog_lazy_fmt.get();
+#endif
 
 	if (!_writer.init()) {
 		PX4_ERR("writer init failed");
@@ -749,53 +897,46 @@ void Logger::run()
 			/* wait for lock on log buffer */
 			_writer.lock();
 
-			for (int sub_idx = 0; sub_idx < _num_subscriptions; ++sub_idx) {
-				LoggerSubscription &sub = _subscriptions[sub_idx];
-				/* if this topic has been updated, copy the new data into the message buffer
-				 * and write a message to the log
-				 */
-				const bool try_to_subscribe = (sub_idx == next_subscribe_topic_index);
-
-				if (copy_if_updated(sub_idx, _msg_buffer + sizeof(ulog_message_data_s), try_to_subscribe)) {
-					// each message consists of a header followed by an orb data object
-					const size_t msg_size = sizeof(ulog_message_data_s) + sub.get_topic()->o_size_no_padding;
-					const uint16_t write_msg_size = static_cast<uint16_t>(msg_size - ULOG_MSG_HEADER_LEN);
-					const uint16_t write_msg_id = sub.msg_id;
-
-					//write one byte after another (necessary because of alignment)
-					_msg_buffer[0] = (uint8_t)write_msg_size;
-					_msg_buffer[1] = (uint8_t)(write_msg_size >> 8);
-					_msg_buffer[2] = static_cast<uint8_t>(ULogMessageType::DATA);
-					_msg_buffer[3] = (uint8_t)write_msg_id;
-					_msg_buffer[4] = (uint8_t)(write_msg_id >> 8);
+#if defined(CONFIG_LOGGER_BACKPRESSURE)
+			update_backpressure(loop_time);
+#endif
 
-					// PX4_INFO("topic: %s, size = %zu, out_size = %zu", sub.get_topic()->o_name, sub.get_topic()->o_size, msg_size);
+#if defined(CONFIG_LOGGER_LAZY_FORMATS)
 
-					// full log
-					if (write_message(LogType::Full, _msg_buffer, msg_size)) {
+			if (_lazy_formats) {
+				write_pending_definitions();
+			}
 
-#ifdef DBGPRINT
-						total_bytes += msg_size;
-#endif /* DBGPRINT */
-					}
+#endif
 
-					// mission log
-					if (sub_idx < _num_mission_subs) {
-						if (_writer.is_started(LogType::Mission)) {
-							if (_mission_subscriptions[sub_idx].next_write_time < (loop_time / 100000)) {
-								unsigned delta_time = _mission_subscriptions[sub_idx].min_delta_ms;
+#if defined(CONFIG_LOGGER_EVENT_DRIVEN)
 
-								if (delta_time > 0) {
-									_mission_subscriptions[sub_idx].next_write_time = (loop_time / 100000) + delta_time / 100;
-								}
+			// only visit the subscriptions that got published (and the one we try to subscribe to)
+			for (int i = 0; i < UPDATED_FLAGS_SIZE; ++i) {
+				uint32_t updated_flags = _updated_flags[i].fetch_and(0);
 
-								write_message(LogType::Mission, _msg_buffer, msg_size);
-							}
-						}
+				if (next_subscribe_topic_index >= 0 && next_subscribe_topic_index / 32 == i) {
+					updated_flags |= 1u << (next_subscribe_topic_index % 32);
+				}
+
+				while (updated_flags != 0) {
+					const int sub_idx = i * 32 + __builtin_ctz(updated_flags);
+					updated_flags &= updated_flags - 1;
+
+					if (sub_idx < _num_subscriptions) {
+						write_subscription_data(sub_idx, sub_idx == next_subscribe_topic_index, loop_time, total_bytes);
 					}
 				}
 			}
 
+#else
+
+			for (int sub_idx = 0; sub_idx < _num_subscriptions; ++sub_idx) {
+				write_subscription_data(sub_idx, sub_idx == next_subscribe_topic_index, loop_time, total_bytes);
+			}
+
+#endif
+
 			// check for new events
 			handle_event_updates(total_bytes);
 
@@ -841,6 +982,15 @@ void Logger::run()
 				_last_sync_time = loop_time;
 			}
 
+#if defined(CONFIG_LOGGER_INDEX)
+
+			if (_indexing && loop_time - _index_last_write > INDEX_INTERVAL) {
+				// on overflow, retry in the next iteration
+				write_index(loop_time);
+			}
+
+#endif
+
 			// update buffer statistics
 			for (int i = 0; i < (int)LogType::Count; ++i) {
 				if (!_statistics[i].dropout_start && (_writer.get_buffer_fill_count_file((LogType)i) > _statistics[i].high_water)) {
@@ -879,6 +1029,9 @@ void Logger::run()
 			if (next_subscribe_topic_index != -1) {
 				if (!_subscriptions[next_subscribe_topic_index].valid()) {
 					_subscriptions[next_subscribe_topic_index].subscribe();
+#if defined(CONFIG_LOGGER_EVENT_DRIVEN)
+					register_updated_flag(next_subscribe_topic_index);
+#endif
 				}
 
 				if (++next_subscribe_topic_index >= _num_subscriptions) {
@@ -1198,6 +1351,245 @@ void Logger::handle_vehicle_command_update()
 	}
 }
 
+bool Logger::write_data_message(LoggerSubscription &sub, size_t msg_size, hrt_abstime now)
+{
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+	DeltaEncoder *encoder = sub.delta_encoder;
+
+	if (encoder && _delta_encoding) {
+		const uint8_t *sample = _msg_buffer + sizeof(ulog_message_data_s);
+		const size_t delta_size = encoder->encode(sub.msg_id, sample, _delta_buffer, now);
+		const bool keyframe = delta_size == 0;
+
+		// the encoder state must follow what is in the file, so only update it if the message got written
+		if (keyframe ? write_message(LogType::Full, _msg_buffer, msg_size)
+		    : write_message(LogType::Full, _delta_buffer, delta_size)) {
+			encoder->written(sample, keyframe, now);
+#if defined(CONFIG_LOGGER_INDEX)
+
+			if (keyframe) {
+				add_index_entry(ULogMessageType::DATA, sub.msg_id, msg_size, sample);
+			}
+
+#endif
+			return true;
+		}
+
+		return false;
+	}
+
+#endif
+
+	if (write_message(LogType::Full, _msg_buffer, msg_size)) {
+#if defined(CONFIG_LOGGER_INDEX)
+		add_index_entry(ULogMessageType::DATA, sub.msg_id, msg_size, _msg_buffer + sizeof(ulog_message_data_s));
+#endif
+		return true;
+	}
+
+	return false;
+}
+
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+void Logger::initialize_delta_encoders()
+{
+	if (!_param_sdlog_delta.get()) {
+		return;
+	}
+
+	_delta_buffer = new uint8_t[_msg_buffer_len];
+
+	if (!_delta_buffer) {
+		PX4_ERR("alloc failed");
+		return;
+	}
+
+	for (int i = 0; i < _num_subscriptions; ++i) {
+		const orb_metadata *meta = _subscriptions[i].get_topic();
+
+		if (DeltaEncoder::enabled_for((ORB_ID)meta->o_id)) {
+			DeltaEncoder *encoder = new DeltaEncoder(meta);
+
+			if (encoder && !encoder->valid()) {
+				delete encoder;
+				encoder = nullptr;
+			}
+
+			if (!encoder) {
+				PX4_ERR("alloc failed");
+				continue;
+			}
+
+			_subscriptions[i].delta_encoder = encoder;
+		}
+	}
+}
+#endif
+
+#if defined(CONFIG_LOGGER_BACKPRESSURE)
+void Logger::update_backpressure(hrt_abstime now)
+{
+	if (!_param_sdlog_adaptive.get() || !_writer.is_started(LogType::Full, LogWriter::BackendFile)) {
+		if (_backpressure.level() != 0) {
+			_backpressure.reset();
+			apply_backpressure_intervals();
+		}
+
+		return;
+	}
+
+	const int previous_level = _backpressure.level();
+
+	if (_backpressure.update(_writer.get_buffer_fill_count_file(LogType::Full),
+				 _writer.get_buffer_size_file(LogType::Full),
+				 _writer.get_write_stall_file(LogType::Full, now), now)) {
+
+		apply_backpressure_intervals();
+
+		Statistics &stats = _statistics[(int)LogType::Full];
+
+		if (_backpressure.level() > stats.max_backpressure_level) {
+			stats.max_backpressure_level = _backpressure.level();
+		}
+
+		if (previous_level == 0) {
+			PX4_WARN("write pressure: reducing logging rate");
+
+		} else if (_backpressure.level() == 0) {
+			PX4_INFO("write pressure gone: logging rate restored");
+
+		} else {
+			PX4_DEBUG("write pressure level %i", _backpressure.level());
+		}
+	}
+}
+
+void Logger::apply_backpressure_intervals()
+{
+	for (int i = 0; i < _num_subscriptions; ++i) {
+		LoggerSubscription &sub = _subscriptions[i];
+		sub.set_interval_us(_backpressure.interval_us(sub.priority, sub.configured_interval_us));
+	}
+}
+#endif
+
+#if defined(CONFIG_LOGGER_INDEX)
+void Logger::initialize_index()
+{
+	if (!_param_sdlog_index.get()) {
+		return;
+	}
+
+	// at most one ADD_LOGGED_MSG and one DATA entry per subscription
+	_index_max_entries = 2 * _num_subscriptions;
+	_index_buffer = new uint8_t[sizeof(ulog_message_index_s) + _index_max_entries * sizeof(ulog_message_index_entry_s)];
+
+	if (!_index_buffer) {
+		PX4_ERR("alloc failed");
+	}
+}
+
+void Logger::add_index_entry(ULogMessageType type, uint16_t msg_id, size_t msg_size, const uint8_t *sample)
+{
+	if (!_indexing) {
+		return;
+	}
+
+	if (type == ULogMessageType::DATA) {
+		if (_index_num_entries >= _index_max_entries || msg_id >= _index_has_data.size() || _index_has_data[msg_id]) {
+			return;
+		}
+
+		_index_has_data.set(msg_id);
+	}
+
+	ulog_message_index_entry_s entry;
+	entry.msg_type = static_cast<uint8_t>(type);
+	entry.msg_id = msg_id;
+	// offset in the uncompressed stream, also if the file is compressed (see SDLOG_INDEX)
+	entry.offset = _writer.get_stream_offset_file(LogType::Full) - msg_size;
+	entry.timestamp = 0;
+
+	if (sample) {
+		// the timestamp is the first field of every topic
+		memcpy(&entry.timestamp, sample, sizeof(entry.timestamp));
+	}
+
+	if (_index_num_entries >= _index_max_entries) {
+		// definitions must not be missing from the index (with lazy formats there can be more than one per
+		// subscription), so start a new index message
+		if (!write_index(hrt_absolute_time())) {
+			return;
+		}
+	}
+
+	memcpy(_index_buffer + sizeof(ulog_message_index_s) + _index_num_entries * sizeof(entry), &entry, sizeof(entry));
+	++_index_num_entries;
+}
+
+bool Logger::write_index(hrt_abstime now)
+{
+	ulog_message_index_s index;
+	const size_t msg_size = sizeof(index) + _index_num_entries * sizeof(ulog_message_index_entry_s);
+	index.msg_size = msg_size - ULOG_MSG_HEADER_LEN;
+	index.offset = _writer.get_stream_offset_file(LogType::Full);
+
+	if (_statistics[(int)LogType::Full].dropout_start) {
+		// the dropout message is written first
+		index.offset += sizeof(ulog_message_dropout_s);
+	}
+
+	index.previous_index_offset = _index_previous_offset;
+	index.timestamp = now;
+	memcpy(_index_buffer, &index, sizeof(index));
+
+	if (!write_message(LogType::Full, _index_buffer, msg_size)) {
+		return false;
+	}
+
+	_index_previous_offset = index.offset;
+	_index_last_write = now;
+	_index_num_entries = 0;
+	_index_has_data.reset();
+
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+
+	// start the next index with keyframes, so that each DATA entry can be decoded on its own
+	if (_delta_encoding) {
+		for (int i = 0; i < _num_subscriptions; ++i) {
+			if (_subscriptions[i].delta_encoder) {
+				_subscriptions[i].delta_encoder->reset();
+			}
+		}
+	}
+
+#endif
+
+	return true;
+}
+
+void Logger::write_index_footer()
+{
+	if (!_indexing) {
+		return;
+	}
+
+	_writer.lock();
+
+	if (write_index(hrt_absolute_time())) {
+		ulog_message_index_footer_s footer;
+		footer.msg_size = sizeof(footer) - ULOG_MSG_HEADER_LEN;
+		footer.index_offset = _index_previous_offset;
+		memcpy(footer.magic, "ULogIdx", 7);
+		footer.magic[7] = 1; // index version
+		write_message(LogType::Full, &footer, sizeof(footer));
+	}
+
+	_indexing = false;
+	_writer.unlock();
+}
+#endif
+
 bool Logger::write_message(LogType type, void *ptr, size_t size)
 {
 	Statistics &stats = _statistics[(int)type];
@@ -1303,6 +1695,15 @@ int Logger::get_log_file_name(LogType type, char *file_name, size_t file_name_si
 		replay_suffix = "_replayed";
 	}
 
+	const char *compression_suffix = "";
+#if defined(CONFIG_LOGGER_COMPRESSION)
+
+	if (type == LogType::Full && _param_sdlog_compress.get()) {
+		compression_suffix = "z";
+	}
+
+#endif
+
 	const char *crypto_suffix = "";
 #if defined(PX4_CRYPTO)
 
@@ -1323,8 +1724,8 @@ int Logger::get_log_file_name(LogType type, char *file_name, size_t file_name_si
 
 		char log_file_name_time[16] = "";
 		strftime(log_file_name_time, sizeof(log_file_name_time), "%H_%M_%S", &tt);
-		snprintf(log_file_name, sizeof(LogFileName::log_file_name), "%s%s.ulg%s", log_file_name_time, replay_suffix,
-			 crypto_suffix);
+		snprintf(log_file_name, sizeof(LogFileName::log_file_name), "%s%s.ulg%s%s", log_file_name_time, replay_suffix,
+			 compression_suffix, crypto_suffix);
 		snprintf(file_name + n, file_name_size - n, "/%s", log_file_name);
 
 		if (notify) {
@@ -1354,8 +1755,8 @@ int Logger::get_log_file_name(LogType type, char *file_name, size_t file_name_si
 		/* look for the next file that does not exist */
 		while (file_number <= MAX_NO_LOGFILE) {
 			/* format log file path: e.g. /fs/microsd/log/sess001/log001.ulg */
-			snprintf(log_file_name, sizeof(LogFileName::log_file_name), "log%03" PRIu16 "%s.ulg%s", file_number, replay_suffix,
-				 crypto_suffix);
+			snprintf(log_file_name, sizeof(LogFileName::log_file_name), "log%03" PRIu16 "%s.ulg%s%s", file_number, replay_suffix,
+				 compression_suffix, crypto_suffix);
 			snprintf(file_name + n, file_name_size - n, "/%s", log_file_name);
 
 			if (!util::file_exist(file_name)) {
@@ -1421,7 +1822,51 @@ void Logger::start_log_file(LogType type)
 		_param_sdlog_crypto_exchange_key.get());
 #endif
 
+#if defined(CONFIG_LOGGER_COMPRESSION)
+	_writer.set_compression(_param_sdlog_compress.get());
+#endif
+
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+
+	if (type == LogType::Full) {
+		// the mavlink backend can drop messages, which would break the decoding of the deltas
+		_delta_encoding = _delta_buffer && !_writer.is_started(LogType::Full, LogWriter::BackendMavlink);
+
+		for (int i = 0; i < _num_subscriptions; ++i) {
+			if (_subscriptions[i].delta_encoder) {
+				_subscriptions[i].delta_encoder->reset();
+			}
+		}
+	}
+
+#endif
+
+#if defined(CONFIG_LOGGER_INDEX)
+
+	if (type == LogType::Full) {
+		_indexing = _index_buffer && !_writer.is_started(LogType::Full, LogWriter::BackendMavlink);
+		_index_num_entries = 0;
+		_index_has_data.reset();
+		_index_previous_offset = 0;
+		_index_last_write = hrt_absolute_time();
+	}
+
+#endif
+
 	if (_writer.start_log_file(type, file_name)) {
+#if defined(CONFIG_LOGGER_BACKPRESSURE)
+
+		if (type == LogType::Full && _backpressure.level() != 0) {
+			_backpressure.reset();
+			apply_backpressure_intervals();
+		}
+
+#endif
+
+#if defined(CONFIG_LOGGER_LAZY_FORMATS)
+		reset_definitions(type == LogType::Full ? DefinitionStream::FileFull : DefinitionStream::FileMission);
+#endif
+
 		_writer.select_write_backend(LogWriter::BackendFile);
 		_writer.set_need_reliable_transfer(true);
 
@@ -1462,6 +1907,9 @@ void Logger::stop_log_file(LogType type)
 	if (type == LogType::Full) {
 		_writer.set_need_reliable_transfer(true);
 		write_perf_data(PrintLoadReason::Postflight);
+#if defined(CONFIG_LOGGER_INDEX)
+		write_index_footer();
+#endif
 		_writer.set_need_reliable_transfer(false);
 	}
 
@@ -1483,7 +1931,21 @@ void Logger::start_log_mavlink()
 
 	PX4_INFO("Start mavlink log");
 
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+	// both backends receive the same data stream (the file log continues with regular data messages)
+	_delta_encoding = false;
+#endif
+
+#if defined(CONFIG_LOGGER_INDEX)
+	// the file offsets do not apply to the mavlink stream, so the index of the file log ends here
+	_indexing = false;
+#endif
+
+	_writer.set_mavlink_ack_window(_param_sdlog_mav_win.get());
 	_writer.start_log_mavlink();
+#if defined(CONFIG_LOGGER_LAZY_FORMATS)
+	reset_definitions(DefinitionStream::Mavlink);
+#endif
 	_writer.select_write_backend(LogWriter::BackendMavlink);
 	_writer.set_need_reliable_transfer(true);
 	write_header(LogType::Full);
@@ -1496,6 +1958,13 @@ void Logger::start_log_mavlink()
 	write_events_file(LogType::Full);
 	write_excluded_optional_topics(LogType::Full);
 	write_all_add_logged_msg(LogType::Full);
+#if defined(CONFIG_LOGGER_LAZY_FORMATS)
+
+	if (lazy_formats()) {
+		write_mavlink_definitions();
+	}
+
+#endif
 	_writer.set_need_reliable_transfer(false);
 	_writer.unselect_write_backend();
 	_writer.notify();
@@ -1688,9 +2157,6 @@ void Logger::write_formats(LogType type)
 {
 	_writer.lock();
 
-	// This is large and thus we need to be careful in terms of stack size requirements
-	ulog_message_format_s msg;
-
 	// Write all subscribed formats
 	int sub_count = _num_subscriptions;
 
@@ -1698,6 +2164,11 @@ void Logger::write_formats(LogType type)
 		sub_count = _num_mission_subs;
 	}
 
+	if (lazy_formats()) {
+		// written on first use
+		sub_count = 0;
+	}
+
 	// Keep a bitset of all required formats (nested definitions are added later on to the bitset)
 	px4::Bitset<ORB_TOPICS_COUNT> formats_to_write;
 
@@ -1714,6 +2185,16 @@ void Logger::write_formats(LogType type)
 
 	formats_to_write.set(_event_subscription.get_topic()->o_id);
 
+	write_formats(type, formats_to_write, nullptr);
+
+	_writer.unlock();
+}
+
+void Logger::write_formats(LogType type, px4::Bitset<ORB_TOPICS_COUNT> &formats_to_write,
+			   px4::Bitset<ORB_TOPICS_COUNT> *formats_written)
+{
+	// This is large and thus we need to be careful in terms of stack size requirements
+	ulog_message_format_s msg;
 
 	static_assert(sizeof(msg.format) > uORB::orb_tokenized_fields_max_length, "uORB message definition too long");
 	uORB::MessageFormatReader format_reader(msg.format, sizeof(msg.format));
@@ -1735,6 +2216,12 @@ void Logger::write_formats(LogType type)
 						continue;
 					}
 
+					if (formats_written && (*formats_written)[orb_id]) {
+						// already in the log, including its dependencies
+						formats_to_write.set(orb_id, false);
+						continue;
+					}
+
 					// Make sure to write dependencies too
 					for (const orb_id_size_t orb_id_dep : format_reader.orbIDsDependencies()) {
 						formats_to_write.set(orb_id_dep);
@@ -1786,6 +2273,32 @@ void Logger::write_formats(LogType type)
 					size_t msg_size = sizeof(msg) - sizeof(msg.format) + format_length;
 					msg.msg_size = msg_size - ULOG_MSG_HEADER_LEN;
 					write_message(type, &msg, msg_size);
+
+					if (formats_written) {
+						formats_written->set(orb_id);
+#if defined(CONFIG_LOGGER_INDEX)
+
+						if (type == LogType::Full) {
+							// in the data section, so readers using the index need to find it
+							add_index_entry(ULogMessageType::FORMAT, 0, msg_size, nullptr);
+						}
+
+#endif
+					}
+
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+
+					if (type == LogType::Full) {
+						for (int i = 0; i < _num_subscriptions; ++i) {
+							DeltaEncoder *encoder = _subscriptions[i].delta_encoder;
+
+							if (encoder && encoder->topic()->o_id == orb_id) {
+								encoder->set_fields(msg.format + name_length, format_length - name_length);
+							}
+						}
+					}
+
+#endif
 				}
 
 				// Move left-over back
@@ -1811,9 +2324,8 @@ void Logger::write_formats(LogType type)
 	if (formats_to_write.count() > 0) {
 		// Getting here is a bug. Maybe the ordering of nested formats is not as expected?
 		PX4_ERR("Not all formats written");
+		formats_to_write.reset();
 	}
-
-	_writer.unlock();
 }
 
 void Logger::write_all_add_logged_msg(LogType type)
@@ -1826,6 +2338,11 @@ void Logger::write_all_add_logged_msg(LogType type)
 		sub_count = _num_mission_subs;
 	}
 
+	if (lazy_formats()) {
+		// written on first use
+		sub_count = 0;
+	}
+
 	bool added_subscriptions = false;
 
 	for (int i = 0; i < sub_count; ++i) {
@@ -1841,7 +2358,7 @@ void Logger::write_all_add_logged_msg(LogType type)
 
 	_writer.unlock();
 
-	if (!added_subscriptions) {
+	if (!added_subscriptions && !lazy_formats()) {
 		PX4_ERR("No subscriptions added"); // this results in invalid log files
 	}
 }
@@ -1872,10 +2389,175 @@ void Logger::write_add_logged_msg(LogType type, LoggerSubscription &subscription
 
 	bool prev_reliable = _writer.need_reliable_transfer();
 	_writer.set_need_reliable_transfer(true);
+
 	write_message(type, &msg, msg_size);
+
+#if defined(CONFIG_LOGGER_INDEX)
+
+	if (type == LogType::Full) {
+		// written with reliable transfer, so it cannot be dropped
+		add_index_entry(ULogMessageType::ADD_LOGGED_MSG, msg.msg_id, msg_size, nullptr);
+	}
+
+#endif
+
+	_writer.set_need_reliable_transfer(prev_reliable);
+}
+
+#if defined(CONFIG_LOGGER_LAZY_FORMATS)
+void Logger::reset_definitions(DefinitionStream stream)
+{
+	_formats_written[(int)stream].reset();
+
+	for (int i = 0; i < _num_subscriptions; ++i) {
+		_subscriptions[i].defined_streams &= ~(1u << (int)stream);
+	}
+
+	_definitions_pending = true;
+}
+
+bool Logger::definition_stream_started(DefinitionStream stream) const
+{
+	switch (stream) {
+	case DefinitionStream::FileFull:
+		return _writer.is_started(LogType::Full, LogWriter::BackendFile);
+
+	case DefinitionStream::FileMission:
+		return _writer.is_started(LogType::Mission, LogWriter::BackendFile);
+
+	case DefinitionStream::Mavlink:
+		return _writer.is_started(LogType::Full, LogWriter::BackendMavlink);
+
+	default:
+		return false;
+	}
+}
+
+void Logger::write_definitions(DefinitionStream stream, const px4::Bitset<LoggedTopics::MAX_TOPICS_NUM> &subs)
+{
+	if (!definition_stream_started(stream)) {
+		return;
+	}
+
+	const LogType type = stream == DefinitionStream::FileMission ? LogType::Mission : LogType::Full;
+	const int sub_count = type == LogType::Mission ? _num_mission_subs : _num_subscriptions;
+	const uint8_t stream_mask = 1u << (int)stream;
+	px4::Bitset<ORB_TOPICS_COUNT> formats_to_write;
+	bool needs_definitions = false;
+
+	for (int i = 0; i < sub_count; ++i) {
+		if (subs[i] && !(_subscriptions[i].defined_streams & stream_mask)) {
+			formats_to_write.set(_subscriptions[i].get_topic()->o_id);
+			needs_definitions = true;
+		}
+	}
+
+	if (!needs_definitions) {
+		return;
+	}
+
+	// the other streams already have (or do not need) the definitions, and all of them must be delivered
+	_writer.select_write_backend(stream == DefinitionStream::Mavlink ? LogWriter::BackendMavlink : LogWriter::BackendFile);
+	const bool prev_reliable = _writer.need_reliable_transfer();
+	_writer.set_need_reliable_transfer(true);
+
+	// ULog requires the format before the ADD_LOGGED_MSG, which must come before the first sample
+	write_formats(type, formats_to_write, &_formats_written[(int)stream]);
+
+	for (int i = 0; i < sub_count; ++i) {
+		LoggerSubscription &sub = _subscriptions[i];
+
+		if (subs[i] && !(sub.defined_streams & stream_mask)) {
+			write_add_logged_msg(type, sub);
+			sub.defined_streams |= stream_mask;
+		}
+	}
+
 	_writer.set_need_reliable_transfer(prev_reliable);
+	_writer.unselect_write_backend();
+}
+
+void Logger::write_definitions(LogType type, int sub_idx)
+{
+	const uint8_t defined_streams = _subscriptions[sub_idx].defined_streams;
+
+	for (int i = 0; i < (int)DefinitionStream::Count; ++i) {
+		const DefinitionStream stream = (DefinitionStream)i;
+		const LogType stream_type = stream == DefinitionStream::FileMission ? LogType::Mission : LogType::Full;
+
+		if (stream_type == type && !(defined_streams & (1u << i))) {
+			px4::Bitset<LoggedTopics::MAX_TOPICS_NUM> subs;
+			subs.set(sub_idx);
+			write_definitions(stream, subs);
+		}
+	}
 }
 
+void Logger::write_pending_definitions()
+{
+	if (!_definitions_pending) {
+		return;
+	}
+
+	uint8_t started_streams = 0;
+
+	for (int i = 0; i < (int)DefinitionStream::Count; ++i) {
+		if (definition_stream_started((DefinitionStream)i)) {
+			started_streams |= 1u << i;
+		}
+	}
+
+	const uint8_t mission_mask = 1u << (int)DefinitionStream::FileMission;
+	px4::Bitset<LoggedTopics::MAX_TOPICS_NUM> updated_subs;
+	bool pending = false;
+
+	for (int sub_idx = 0; sub_idx < _num_subscriptions; ++sub_idx) {
+		LoggerSubscription &sub = _subscriptions[sub_idx];
+		const uint8_t required_streams = sub_idx < _num_mission_subs ? started_streams : (started_streams & ~mission_mask);
+
+		if (sub.valid() && (sub.defined_streams & required_streams) != required_streams) {
+			// not published since the stream started
+			pending = true;
+
+			if (sub.updated()) {
+				updated_subs.set(sub_idx);
+			}
+		}
+	}
+
+	_definitions_pending = pending;
+
+	for (int i = 0; i < (int)DefinitionStream::Count; ++i) {
+		write_definitions((DefinitionStream)i, updated_subs);
+	}
+}
+
+void Logger::write_mavlink_definitions()
+{
+	const uint8_t stream_mask = 1u << (int)DefinitionStream::Mavlink;
+	px4::Bitset<ORB_TOPICS_COUNT> formats_to_write;
+
+	_writer.lock();
+
+	for (int i = 0; i < _num_subscriptions; ++i) {
+		formats_to_write.set(_subscriptions[i].get_topic()->o_id);
+	}
+
+	write_formats(LogType::Full, formats_to_write, &_formats_written[(int)DefinitionStream::Mavlink]);
+
+	for (int i = 0; i < _num_subscriptions; ++i) {
+		LoggerSubscription &sub = _subscriptions[i];
+
+		if (sub.valid()) {
+			write_add_logged_msg(LogType::Full, sub);
+			sub.defined_streams |= stream_mask;
+		}
+	}
+
+	_writer.unlock();
+}
+#endif
+
 void Logger::write_info(LogType type, const char *name, const char *value)
 {
 	_writer.lock();
@@ -2045,6 +2727,26 @@ void Logger::write_header(LogType type)
 
 	flag_bits.compat_flags[0] = ULOG_COMPAT_FLAG0_DEFAULT_PARAMETERS_MASK;
 
+#if defined(CONFIG_LOGGER_INDEX)
+
+	if (type == LogType::Full && _indexing) {
+		flag_bits.compat_flags[0] |= ULOG_COMPAT_FLAG0_INDEX_MASK;
+	}
+
+#endif
+
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+
+	if (type == LogType::Full && _delta_encoding) {
+		flag_bits.incompat_flags[0] |= ULOG_INCOMPAT_FLAG0_DATA_DELTA_MASK;
+	}
+
+#endif
+
+	if (lazy_formats()) {
+		flag_bits.incompat_flags[0] |= ULOG_INCOMPAT_FLAG0_LAZY_FORMATS_MASK;
+	}
+
 	flag_bits.msg_size = sizeof(flag_bits) - ULOG_MSG_HEADER_LEN;
 	flag_bits.msg_type = static_cast<uint8_t>(ULogMessageType::FLAG_BITS);
 
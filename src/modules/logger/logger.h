@@ -37,7 +37,14 @@
 #include "logged_topics.h"
 #include "messages.h"
 #include "watchdog.h"
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+#include "delta_encoder.h"
+#endif
+#if defined(CONFIG_LOGGER_BACKPRESSURE)
+#include "backpressure.h"
+#endif
 #include <containers/Array.hpp>
+#include <containers/Bitset.hpp>
 #include "util.h"
 #include <px4_platform_common/defines.h>
 #include <drivers/drv_hrt.h>
@@ -50,6 +57,9 @@
 #include <uORB/PublicationMulti.hpp>
 #include <uORB/Subscription.hpp>
 #include <uORB/SubscriptionInterval.hpp>
+#if defined(CONFIG_LOGGER_EVENT_DRIVEN)
+#include <uORB/SubscriptionCallback.hpp>
+#endif
 #include <uORB/topics/logger_status.h>
 #include <uORB/topics/log_message.h>
 #include <uORB/topics/manual_control_setpoint.h>
@@ -71,14 +81,63 @@ namespace logger
 
 static constexpr uint8_t MSG_ID_INVALID = UINT8_MAX;
 
-struct LoggerSubscription : public uORB::SubscriptionInterval {
-	LoggerSubscription() = default;
+#if defined(CONFIG_LOGGER_EVENT_DRIVEN)
+using LoggerSubscriptionBase = uORB::SubscriptionCallback;
+#else
+using LoggerSubscriptionBase = uORB::SubscriptionInterval;
+#endif
+
+struct LoggerSubscription : public LoggerSubscriptionBase {
+	LoggerSubscription() : LoggerSubscriptionBase(nullptr) {}
 
 	LoggerSubscription(ORB_ID id, uint32_t interval_ms = 0, uint8_t instance = 0) :
-		uORB::SubscriptionInterval(id, interval_ms * 1000, instance)
+		LoggerSubscriptionBase(get_orb_meta(id), interval_ms * 1000, instance)
 	{}
 
+#if defined(CONFIG_LOGGER_EVENT_DRIVEN)
+	/**
+	 * Register for publication callbacks, which set the given bit. Call after a successful subscribe().
+	 * The bit is set initially, so that already published data is checked as well.
+	 */
+	void register_updated_flag(px4::atomic<uint32_t> *updated_flags, uint32_t mask)
+	{
+		_updated_flags = updated_flags;
+		_updated_mask = mask;
+
+		if (registerCallback()) {
+			call();
+		}
+	}
+
+	/** @return true if there is unread data, ignoring the interval */
+	bool pending() { return _subscription.updated(); }
+
+	/** called on each publication (from the publisher's context) */
+	void call() override
+	{
+		if (_updated_flags) {
+			_updated_flags->fetch_or(_updated_mask);
+		}
+	}
+#endif
+
 	uint8_t msg_id{MSG_ID_INVALID};
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+	DeltaEncoder *delta_encoder{nullptr}; ///< set if the topic is delta encoded in the full log
+#endif
+#if defined(CONFIG_LOGGER_BACKPRESSURE)
+	TopicPriority priority{TopicPriority::Normal};
+	uint32_t configured_interval_us{0}; ///< interval without write pressure
+#endif
+#if defined(CONFIG_LOGGER_LAZY_FORMATS)
+	uint8_t defined_streams{0}; ///< bit per Logger::DefinitionStream, set once the formats and ADD_LOGGED_MSG are written
+#endif
+
+#if defined(CONFIG_LOGGER_EVENT_DRIVEN)
+private:
+	px4::atomic<uint32_t> *_updated_flags{nullptr};
+	uint32_t _updated_mask{0};
+#endif
 };
 
 class Logger : public ModuleBase<Logger>, public ModuleParams
@@ -174,6 +233,10 @@ private:
 		hrt_abstime dropout_start{0};				///< start of current dropout (0 = no dropout)
 		float max_dropout_duration{0.0f};			///< max duration of dropout [s]
 		size_t write_dropouts{0};				///< failed buffer writes due to buffer overflow
+#if defined(CONFIG_LOGGER_BACKPRESSURE)
+		size_t shed_messages{0};				///< samples not written to keep the buffer for critical topics
+		int max_backpressure_level{0};
+#endif
 		size_t high_water{0};					///< maximum used write buffer
 	};
 
@@ -228,6 +291,16 @@ private:
 		       && (_writer.backend() & LogWriter::BackendMavlink) != 0;
 	}
 
+	/** @return true if formats and subscriptions are written on first use (SDLOG_LAZY_FMT) */
+	bool lazy_formats() const
+	{
+#if defined(CONFIG_LOGGER_LAZY_FORMATS)
+		return _lazy_formats;
+#else
+		return false;
+#endif
+	}
+
 	/** get the configured backend as string */
 	const char *configured_backend_mode() const;
 
@@ -238,6 +311,15 @@ private:
 
 	void write_formats(LogType type);
 
+	/**
+	 * Write the formats in formats_to_write (and their nested formats) in the order of the format definitions.
+	 * _writer.lock() must be held when calling this.
+	 * @param formats_to_write formats to write, cleared when returning
+	 * @param formats_written if not null, formats that are skipped, and the written ones are added
+	 */
+	void write_formats(LogType type, px4::Bitset<ORB_TOPICS_COUNT> &formats_to_write,
+			   px4::Bitset<ORB_TOPICS_COUNT> *formats_written);
+
 	/**
 	 * write performance counters
 	 */
@@ -280,6 +362,20 @@ private:
 
 	inline bool copy_if_updated(int sub_idx, void *buffer, bool try_to_subscribe);
 
+	/**
+	 * Check a subscription for updates and write new data to the log(s).
+	 * Must be called with _writer.lock() held.
+	 */
+	inline void write_subscription_data(int sub_idx, bool try_to_subscribe, hrt_abstime loop_time,
+					    uint32_t &total_bytes);
+
+#if defined(CONFIG_LOGGER_EVENT_DRIVEN)
+	/**
+	 * Register the publication callback of a subscription (if it is valid)
+	 */
+	void register_updated_flag(int sub_idx);
+#endif
+
 	/**
 	 * Write exactly one ulog message to the logger and handle dropouts.
 	 * Must be called with _writer.lock() held.
@@ -287,6 +383,47 @@ private:
 	 */
 	bool write_message(LogType type, void *ptr, size_t size);
 
+	/**
+	 * Write the topic data in _msg_buffer to the full log, delta encoded if enabled for the subscription.
+	 * Must be called with _writer.lock() held.
+	 * @return true if data written, false otherwise (on overflow)
+	 */
+	bool write_data_message(LoggerSubscription &sub, size_t msg_size, hrt_abstime now);
+
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+	/**
+	 * Create the delta encoders for the subscriptions (if enabled via SDLOG_DELTA)
+	 */
+	void initialize_delta_encoders();
+#endif
+
+#if defined(CONFIG_LOGGER_INDEX)
+	/**
+	 * Allocate the index buffer (if enabled via SDLOG_INDEX)
+	 */
+	void initialize_index();
+
+	/**
+	 * Add the message that was just written to the full log to the index, if it is the first one of its type
+	 * and msg_id since the previous index message.
+	 * Must be called with _writer.lock() held.
+	 * @param sample topic data for DATA messages, nullptr otherwise
+	 */
+	void add_index_entry(ULogMessageType type, uint16_t msg_id, size_t msg_size, const uint8_t *sample);
+
+	/**
+	 * Write an index message for the data since the previous one.
+	 * Must be called with _writer.lock() held.
+	 * @return true if written, false otherwise (on overflow)
+	 */
+	bool write_index(hrt_abstime now);
+
+	/**
+	 * Write the last index message and the footer when closing the full log
+	 */
+	void write_index_footer();
+#endif
+
 	/**
 	 * Add topic subscriptions from SD file if it exists, otherwise add topics based on the configured profile.
 	 * This must be called before start_log() (because it does not write an ADD_LOGGED_MSG message).
@@ -331,6 +468,67 @@ private:
 
 	void publish_logger_status();
 
+#if defined(CONFIG_LOGGER_BACKPRESSURE)
+	/**
+	 * Update the backpressure level from the state of the full log file, and apply it to the subscription intervals.
+	 * Must be called with _writer.lock() held.
+	 */
+	void update_backpressure(hrt_abstime now);
+
+	/**
+	 * Set the subscription intervals for the current backpressure level
+	 */
+	void apply_backpressure_intervals();
+#endif
+
+#if defined(CONFIG_LOGGER_LAZY_FORMATS)
+	/**
+	 * Log streams that get their own format definitions and subscriptions in lazy mode
+	 */
+	enum class DefinitionStream : uint8_t {
+		FileFull = 0,
+		FileMission,
+		Mavlink,
+
+		Count
+	};
+
+	/**
+	 * Reset the written formats and subscriptions of a stream (call when it starts)
+	 */
+	void reset_definitions(DefinitionStream stream);
+
+	bool definition_stream_started(DefinitionStream stream) const;
+
+	/**
+	 * Write the formats and ADD_LOGGED_MSG for the subscriptions in subs that are not yet defined in the stream
+	 * (no-op if the stream is not started).
+	 * _writer.lock() must be held when calling this.
+	 */
+	void write_definitions(DefinitionStream stream, const px4::Bitset<LoggedTopics::MAX_TOPICS_NUM> &subs);
+
+	/**
+	 * Write the definitions of a single subscription to all started streams of a log type.
+	 * _writer.lock() must be held when calling this.
+	 */
+	void write_definitions(LogType type, int sub_idx);
+
+	/**
+	 * Write the definitions of all the subscriptions that got updated but are not defined yet, so that the
+	 * formats for the topics published at log start are written in a single pass.
+	 * _writer.lock() must be held when calling this.
+	 */
+	void write_pending_definitions();
+
+	/**
+	 * Write the formats of all subscriptions and the subscriptions of the valid ones to the MAVLink stream.
+	 * Definitions in the middle of the stream are reliable transfers which block the logger until they are
+	 * acked, so the MAVLink stream defines everything at log start, and only topics that are subscribed
+	 * later need an ADD_LOGGED_MSG (as without lazy formats).
+	 */
+	void write_mavlink_definitions();
+#endif
+
 	/**
 	 * Check for events and log them
 	 */
@@ -341,6 +539,32 @@ private:
 	uint8_t						*_msg_buffer{nullptr};
 	int						_msg_buffer_len{0};
 
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+	uint8_t						*_delta_buffer{nullptr}; ///< output buffer for DATA_DELTA messages (_msg_buffer_len bytes)
+	bool						_delta_encoding{false}; ///< delta encoding active for the current full log file
+#endif
+
+#if defined(CONFIG_LOGGER_INDEX)
+	static constexpr hrt_abstime			INDEX_INTERVAL{1_s};
+	uint8_t						*_index_buffer{nullptr}; ///< index message header followed by the entries
+	int						_index_max_entries{0};
+	int						_index_num_entries{0};
+	px4::Bitset<LoggedTopics::MAX_TOPICS_NUM>	_index_has_data; ///< msg_id has a DATA entry in the current index
+	uint64_t					_index_previous_offset{0};
+	hrt_abstime					_index_last_write{0};
+	bool						_indexing{false}; ///< index active for the current full log file
+#endif
+
+#if defined(CONFIG_LOGGER_BACKPRESSURE)
+	BackpressureController				_backpressure;
+#endif
+
+#if defined(CONFIG_LOGGER_LAZY_FORMATS)
+	px4::Bitset<ORB_TOPICS_COUNT>			_formats_written[(int)DefinitionStream::Count];
+	bool						_lazy_formats{false}; ///< write formats and subscriptions on first use (SDLOG_LAZY_FMT)
+	bool						_definitions_pending{false}; ///< some valid subscriptions are not defined in all streams
+#endif
+
 	LogFileName					_file_name[(int)LogType::Count];
 
 	bool						_prev_file_log_start_state{false}; ///< previous state depending on logging mode (arming or aux1 state)
@@ -354,6 +578,10 @@ private:
 
 	LoggerSubscription	 			*_subscriptions{nullptr}; ///< all subscriptions for full & mission log (in front)
 	int						_num_subscriptions{0};
+#if defined(CONFIG_LOGGER_EVENT_DRIVEN)
+	static constexpr int UPDATED_FLAGS_SIZE = (LoggedTopics::MAX_TOPICS_NUM + 31) / 32;
+	px4::atomic<uint32_t>				_updated_flags[UPDATED_FLAGS_SIZE] {}; ///< bit per subscription, set on publication
+#endif
 	MissionSubscription 				_mission_subscriptions[MAX_MISSION_TOPICS_NUM] {}; ///< additional data for mission subscriptions
 	int						_num_mission_subs{0};
 	LoggerSubscription				_event_subscription; ///< Subscription for the event topic (handled separately)
@@ -397,7 +625,23 @@ private:
 		(ParamInt<px4::params::SDLOG_PROFILE>) _param_sdlog_profile,
 		(ParamInt<px4::params::SDLOG_MISSION>) _param_sdlog_mission,
 		(ParamBool<px4::params::SDLOG_BOOT_BAT>) _param_sdlog_boot_bat,
-		(ParamBool<px4::params::SDLOG_UUID>) _param_sdlog_uuid
+		(ParamBool<px4::params::SDLOG_UUID>) _param_sdlog_uuid,
+		(ParamInt<px4::params::SDLOG_MAV_WIN>) _param_sdlog_mav_win
+#if defined(CONFIG_LOGGER_COMPRESSION)
+		, (ParamBool<px4::params::SDLOG_COMPRESS>) _param_sdlog_compress
+#endif
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+		, (ParamBool<px4::params::SDLOG_DELTA>) _param_sdlog_delta
+#endif
+#if defined(CONFIG_LOGGER_INDEX)
+		, (ParamBool<px4::params::SDLOG_INDEX>) _param_sdlog_index
+#endif
+#if defined(CONFIG_LOGGER_LAZY_FORMATS)
+		, (ParamBool<px4::params::SDLOG_LAZY_FMT>) _param_sdlog_lazy_fmt
+#endif
+#if defined(CONFIG_LOGGER_BACKPRESSURE)
+		, (ParamBool<px4::params::SDLOG_ADAPTIVE>) _param_sdlog_adaptive
+#endif
 #if defined(PX4_CRYPTO)
 		, (ParamInt<px4::params::SDLOG_ALGORITHM>) _param_sdlog_crypto_algorithm,
 		(ParamInt<px4::params::SDLOG_KEY>) _param_sdlog_crypto_key,
@@ -49,6 +49,9 @@ enum class ULogMessageType : uint8_t {
 	LOGGING = 'L',
 	LOGGING_TAGGED = 'C',
 	FLAG_BITS = 'B',
+	DATA_DELTA = 'X',
+	INDEX = 'N',
+	INDEX_FOOTER = 'E',
 };
 
 
@@ -88,6 +91,39 @@ struct ulog_key_header_s {
 	uint8_t	data[0];
 };
 
+/** first bytes of a compressed log file (SDLOG_COMPRESS), followed by compressed blocks */
+struct ulog_compressed_header_s {
+	/* magic identifying the file content */
+	uint8_t magic[7];
+
+	/* version of this header */
+	uint8_t hdr_ver;
+
+	/* compression algorithm (ULOG_COMPRESSION_HEATSHRINK) */
+	uint8_t algorithm;
+
+	/* heatshrink window and lookahead size (log2) */
+	uint8_t window_bits;
+	uint8_t lookahead_bits;
+
+	uint8_t reserved;
+
+	/* maximum uncompressed size of a block */
+	uint16_t block_size;
+};
+
+#define ULOG_COMPRESSION_HEATSHRINK 1
+
+/**
+ * Header of each compressed block, followed by compressed_size bytes. Every block is compressed
+ * on its own, so it can be decompressed without the previous blocks. Together the blocks form a
+ * regular ULog stream.
+ */
+struct ulog_compressed_block_s {
+	uint16_t compressed_size;
+	uint16_t uncompressed_size;
+};
+
 
 /**
  * @brief Message Header for the ULog
@@ -179,6 +215,70 @@ struct ulog_message_data_s {
 	uint16_t msg_id;
 };
 
+/**
+ * @brief Delta encoded Logged Data Message
+ *
+ * Contains only the parts of a topic sample that changed with respect to the previous sample with the same msg_id
+ * (written either as DATA or as DATA_DELTA message). The msg_id is followed by a list of runs, each consisting of
+ * an ulog_message_data_delta_run_s header and 'length' bytes, which are XOR'ed into the previous sample at 'offset'.
+ * A message without runs repeats the previous sample.
+ *
+ * Only used if ULOG_INCOMPAT_FLAG0_DATA_DELTA_MASK is set.
+ */
+struct ulog_message_data_delta_s {
+	uint16_t msg_size; ///< size of message - ULOG_MSG_HEADER_LEN
+	uint8_t msg_type = static_cast<uint8_t>(ULogMessageType::DATA_DELTA);
+
+	uint16_t msg_id;
+};
+
+struct ulog_message_data_delta_run_s {
+	uint16_t offset; ///< byte offset within the sample
+	uint8_t length; ///< number of bytes following the run header
+};
+
+/**
+ * @brief Index Message
+ *
+ * Written periodically into the data section. It lists where each topic's first data message and each
+ * ADD_LOGGED_MSG message since the previous index message are located, so that readers can jump to a topic or a
+ * time window without scanning the file. The index messages are chained backwards via previous_index_offset.
+ *
+ * File offsets refer to the uncompressed and unencrypted ULog stream (starting with ulog_file_header_s).
+ * The header is followed by (msg_size + ULOG_MSG_HEADER_LEN - sizeof(ulog_message_index_s)) /
+ * sizeof(ulog_message_index_entry_s) entries.
+ *
+ * Only used if ULOG_COMPAT_FLAG0_INDEX_MASK is set.
+ */
+struct ulog_message_index_s {
+	uint16_t msg_size; ///< size of message - ULOG_MSG_HEADER_LEN
+	uint8_t msg_type = static_cast<uint8_t>(ULogMessageType::INDEX);
+
+	uint64_t offset; ///< file offset of this message, to validate it when searching backwards in a truncated log
+	uint64_t previous_index_offset; ///< file offset of the previous index message, 0 for the first one
+	uint64_t timestamp; ///< logger time when the index was written [us]
+};
+
+struct ulog_message_index_entry_s {
+	uint8_t msg_type; ///< ADD_LOGGED_MSG or DATA (never DATA_DELTA, so that the sample can be decoded)
+	uint16_t msg_id;
+	uint64_t offset; ///< file offset of the message
+	uint64_t timestamp; ///< timestamp of the sample for DATA, 0 otherwise [us]
+};
+
+/**
+ * @brief Index Footer Message
+ *
+ * Last message of a log that was closed properly (appended data might follow). It points to the last index message.
+ */
+struct ulog_message_index_footer_s {
+	uint16_t msg_size; ///< size of message - ULOG_MSG_HEADER_LEN
+	uint8_t msg_type = static_cast<uint8_t>(ULogMessageType::INDEX_FOOTER);
+
+	uint64_t index_offset; ///< file offset of the last index message
+	uint8_t magic[8]; ///< 'ULogIdx' followed by the index version (1)
+};
+
 /**
  * @brief Information Message
  *
@@ -282,8 +382,11 @@ struct ulog_message_parameter_default_s {
 
 
 #define ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK (1<<0)
+#define ULOG_INCOMPAT_FLAG0_DATA_DELTA_MASK (1<<1) ///< log contains DATA_DELTA messages
+#define ULOG_INCOMPAT_FLAG0_LAZY_FORMATS_MASK (1<<2) ///< FORMAT messages can follow in the data section (before the first ADD_LOGGED_MSG using them)
 
 #define ULOG_COMPAT_FLAG0_DEFAULT_PARAMETERS_MASK (1<<0)
+#define ULOG_COMPAT_FLAG0_INDEX_MASK (1<<1) ///< log contains INDEX messages
 
 struct ulog_message_flag_bits_s {
 	uint16_t msg_size;
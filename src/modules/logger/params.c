@@ -178,6 +178,112 @@ PARAM_DEFINE_INT32(SDLOG_DIRS_MAX, 0);
  */
 PARAM_DEFINE_INT32(SDLOG_UUID, 1);
 
+/**
+ * Ack window for logging via MAVLink
+ *
+ * Number of acked messages (log header and definitions) that can be in flight
+ * when streaming the log via MAVLink. With 1, each message waits for its ack,
+ * which limits the throughput to one message per round trip. Larger windows
+ * speed up the log start on high-bandwidth links (Ethernet, WiFi, UDP to an
+ * onboard computer), but require a receiver that reorders retransmitted
+ * messages (e.g. Tools/mavlink_ulog_streaming.py).
+ *
+ * @min 1
+ * @max 16
+ * @group SD Logging
+ */
+PARAM_DEFINE_INT32(SDLOG_MAV_WIN, 1);
+
+/**
+ * Compress the log file
+ *
+ * If enabled, the full log is compressed with heatshrink in independent blocks
+ * and stored as .ulgz file, which reduces the amount of data written to the SD card.
+ * Use Tools/decompress_ulog.py to convert it into a regular .ulg file. Replay
+ * handles compressed logs directly.
+ *
+ * Requires CONFIG_LOGGER_COMPRESSION.
+ *
+ * @boolean
+ * @group SD Logging
+ */
+PARAM_DEFINE_INT32(SDLOG_COMPRESS, 0);
+
+/**
+ * Delta encode high-rate topics
+ *
+ * If enabled, high-rate topics such as sensor_combined and the IMU FIFO data are
+ * stored in the full log as difference to the previous sample, with a full sample
+ * written at least once per second. This reduces the log size for full-rate logging.
+ * The resulting log is only readable by tools that support delta encoded data
+ * (replay, or after conversion with Tools/decompress_ulog.py).
+ *
+ * Not used for logging via MAVLink. Requires CONFIG_LOGGER_DELTA_ENCODING.
+ *
+ * @boolean
+ * @reboot_required true
+ * @group SD Logging
+ */
+PARAM_DEFINE_INT32(SDLOG_DELTA, 0);
+
+/**
+ * Write an index into the log
+ *
+ * If enabled, the full log contains an index message every second, which lists the
+ * file offsets of the topic subscriptions and of the first sample of each topic
+ * since the previous index, plus a footer pointing to the last index when the log
+ * is closed. Replay and analysis tools use it to find topics without scanning the
+ * whole file. Truncated logs remain indexed up to the last index message.
+ *
+ * The offsets refer to the uncompressed ULog stream: with SDLOG_COMPRESS the index
+ * can only be used after decompressing the log (replay does this automatically).
+ * Expanding delta encoded data (SDLOG_DELTA) with Tools/decompress_ulog.py moves
+ * the messages, the index of such a log is then invalid.
+ *
+ * Not used for logging via MAVLink. Requires CONFIG_LOGGER_INDEX.
+ *
+ * @boolean
+ * @reboot_required true
+ * @group SD Logging
+ */
+PARAM_DEFINE_INT32(SDLOG_INDEX, 0);
+
+/**
+ * Write format definitions on first use
+ *
+ * If enabled, the format definitions and subscription of a topic are written
+ * right before its first sample, instead of for all logged topics when the log
+ * starts. This reduces the amount of data at log start, and topics that are
+ * never published do not appear in the log.
+ *
+ * Not used for logging via MAVLink: the definitions are reliable transfers that
+ * would stall the logger in the middle of the stream until they are acked.
+ *
+ * The log is marked with an incompat flag, as it contains format messages in
+ * the data section. Requires CONFIG_LOGGER_LAZY_FORMATS.
+ *
+ * @boolean
+ * @reboot_required true
+ * @group SD Logging
+ */
+PARAM_DEFINE_INT32(SDLOG_LAZY_FMT, 0);
+
+/**
+ * Adaptive logging rate
+ *
+ * If enabled, the logging rate of low-priority topics (debug and raw sensor data,
+ * and at high pressure all topics except estimator and control topics) is reduced
+ * while the write buffer fills up or writes to the SD card stall, and restored once
+ * the pressure is gone. Close to a buffer overflow, samples of non-critical topics
+ * are not logged at all, so that estimator and control topics do not get dropouts.
+ *
+ * Only applies to file logging. Requires CONFIG_LOGGER_BACKPRESSURE.
+ *
+ * @boolean
+ * @group SD Logging
+ */
+PARAM_DEFINE_INT32(SDLOG_ADAPTIVE, 1);
+
 /**
  * Logfile Encryption algorithm
  *
@@ -53,6 +53,7 @@ MavlinkULog::MavlinkULog(int datarate, float max_rate_factor, uint8_t target_sys
 	  _max_rate_factor(max_rate_factor),
 	  _max_num_messages(math::max(1, (int)ceilf((_rate_calculation_delta_t / 1e6f) * _max_rate_factor * datarate /
 				      (MAVLINK_MSG_ID_LOGGING_DATA_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES)))),
+	  _num_messages_allowed(_max_num_messages),
 	  _current_rate_factor(max_rate_factor)
 {
 	// make sure we won't read any old messages
@@ -68,6 +69,7 @@ MavlinkULog::MavlinkULog(int datarate, float max_rate_factor, uint8_t target_sys
 MavlinkULog::~MavlinkULog()
 {
 	perf_free(_msg_missed_ulog_stream_perf);
+	perf_free(_msg_retransmitted_perf);
 }
 
 void MavlinkULog::start_ack_received()
@@ -95,45 +97,45 @@ int MavlinkULog::handle_update(mavlink_channel_t channel)
 		return 0;
 	}
 
-	// check if we're waiting for an ACK
-	if (_last_sent_time) {
-		bool check_for_updates = false;
+	const hrt_abstime now = hrt_absolute_time();
 
-		if (_ack_received) {
-			_last_sent_time = 0;
-			check_for_updates = true;
-
-		} else {
-
-			if (hrt_elapsed_time(&_last_sent_time) > ulog_stream_ack_s::ACK_TIMEOUT * 1000) {
-				if (++_sent_tries > ulog_stream_ack_s::ACK_MAX_TRIES) {
-					return -ETIMEDOUT;
+	lock();
+	const hrt_abstime timeout = retransmission_timeout();
+	unlock();
 
-				} else {
-					PX4_DEBUG("re-sending ulog mavlink message (try=%i)", _sent_tries);
-					_last_sent_time = hrt_absolute_time();
+	// retransmit messages for which the ack is overdue. Retransmissions take precedence over new data.
+	// The lock is not held while sending, the message data is only written by this thread
+	for (AckedMessage &acked_message : _acked_messages) {
+		if (_current_num_msgs >= _num_messages_allowed) {
+			break;
+		}
 
-					const ulog_stream_s &ulog_data = _ulog_stream_sub.get();
+		lock();
 
-					mavlink_logging_data_acked_t msg;
-					msg.sequence = ulog_data.msg_sequence;
-					msg.length = ulog_data.length;
-					msg.first_message_offset = ulog_data.first_message_offset;
-					msg.target_system = _target_system;
-					msg.target_component = _target_component;
-					memcpy(msg.data, ulog_data.data, sizeof(msg.data));
-					mavlink_msg_logging_data_acked_send_struct(channel, &msg);
-				}
-			}
+		if (!acked_message.in_use || now - acked_message.last_sent_time < timeout) {
+			unlock();
+			continue;
 		}
 
-		if (!check_for_updates) {
-			return 0;
+		if (now - acked_message.first_sent_time > ulog_stream_ack_s::ACK_TIMEOUT * ulog_stream_ack_s::ACK_MAX_TRIES * 1000) {
+			unlock();
+			return -ETIMEDOUT;
 		}
-	}
 
+		acked_message.last_sent_time = now;
+		acked_message.retransmitted = true;
+		unlock();
+
+		_message_lost = true;
+
+		PX4_DEBUG("re-sending ulog mavlink message (seq=%i)", acked_message.data.msg_sequence);
+		perf_count(_msg_retransmitted_perf);
+		send_acked(channel, acked_message.data);
+		++_current_num_msgs;
+	}
 
-	while ((_current_num_msgs < _max_num_messages) && _ulog_stream_sub.updated()) {
+	while ((_current_num_msgs < _num_messages_allowed) && (_num_acked_in_flight.load() < ulog_stream_ack_s::ACK_WINDOW_MAX)
+	       && _ulog_stream_sub.updated()) {
 		const unsigned last_generation = _ulog_stream_sub.get_last_generation();
 		_ulog_stream_sub.update();
 
@@ -145,21 +147,30 @@ int MavlinkULog::handle_update(mavlink_channel_t channel)
 
 		if (ulog_data.timestamp > 0) {
 			if (ulog_data.flags & ulog_stream_s::FLAGS_NEED_ACK) {
-				_sent_tries = 1;
-				_last_sent_time = hrt_absolute_time();
+				AckedMessage *acked_message = nullptr;
+
+				for (AckedMessage &slot : _acked_messages) {
+					if (!slot.in_use) {
+						acked_message = &slot;
+						break;
+					}
+				}
+
+				acked_message->data = ulog_data;
+				acked_message->first_sent_time = now;
+				acked_message->last_sent_time = now;
+				acked_message->retransmitted = false;
+
 				lock();
-				_wait_for_ack_sequence = ulog_data.msg_sequence;
-				_ack_received = false;
+				acked_message->in_use = true;
+
+				if (_num_acked_in_flight.fetch_add(1) > 0) {
+					_window_in_use = true;
+				}
+
 				unlock();
 
-				mavlink_logging_data_acked_t msg;
-				msg.sequence = ulog_data.msg_sequence;
-				msg.length = ulog_data.length;
-				msg.first_message_offset = ulog_data.first_message_offset;
-				msg.target_system = _target_system;
-				msg.target_component = _target_component;
-				memcpy(msg.data, ulog_data.data, sizeof(msg.data));
-				mavlink_msg_logging_data_acked_send_struct(channel, &msg);
+				send_acked(channel, acked_message->data);
 
 			} else {
 				mavlink_logging_data_t msg;
@@ -177,23 +188,68 @@ int MavlinkULog::handle_update(mavlink_channel_t channel)
 	}
 
 	//need to update the rate?
-	hrt_abstime t = hrt_absolute_time();
+	if (now > _next_rate_check) {
+		update_rate(now);
+	}
+
+	return 0;
+}
+
+void MavlinkULog::send_acked(mavlink_channel_t channel, const ulog_stream_s &ulog_data)
+{
+	mavlink_logging_data_acked_t msg;
+	msg.sequence = ulog_data.msg_sequence;
+	msg.length = ulog_data.length;
+	msg.first_message_offset = ulog_data.first_message_offset;
+	msg.target_system = _target_system;
+	msg.target_component = _target_component;
+	memcpy(msg.data, ulog_data.data, sizeof(msg.data));
+	mavlink_msg_logging_data_acked_send_struct(channel, &msg);
+}
+
+hrt_abstime MavlinkULog::retransmission_timeout() const
+{
+	if (!_window_in_use || _rtt_mean <= 0.f) {
+		return ulog_stream_ack_s::ACK_TIMEOUT * 1000;
+	}
+
+	const float timeout = _rtt_mean + 4.f * _rtt_variation;
+	return math::constrain((hrt_abstime)timeout, _min_retransmission_timeout,
+			       (hrt_abstime)ulog_stream_ack_s::ACK_TIMEOUT * 1000);
+}
+
+void MavlinkULog::update_rate(hrt_abstime now)
+{
+	lock();
+	const int num_acks = _num_acks;
+	_num_acks = 0;
+	unlock();
 
-	if (t > _next_rate_check) {
-		if (_current_num_msgs < _max_num_messages) {
-			_current_rate_factor = _max_rate_factor * (float)_current_num_msgs / _max_num_messages;
+	if (_window_in_use) {
+		// a window of acked messages can overrun the link or the receiver: halve the budget when messages
+		// got lost, but not below what the receiver has been able to ack, and recover slowly otherwise
+		if (_message_lost) {
+			_num_messages_allowed = math::max(_num_messages_allowed / 2, num_acks, 1);
 
 		} else {
-			_current_rate_factor = _max_rate_factor;
+			_num_messages_allowed = math::min(_num_messages_allowed + math::max(_max_num_messages / 10, 1),
+							  _max_num_messages);
 		}
+	}
 
-		_current_num_msgs = 0;
-		_next_rate_check = t + _rate_calculation_delta_t;
-		PX4_DEBUG("current rate=%.3f (max=%i msgs in %.3fs)", (double)_current_rate_factor, _max_num_messages,
-			  (double)(_rate_calculation_delta_t / 1e6));
+	if (_current_num_msgs < _max_num_messages) {
+		_current_rate_factor = _max_rate_factor * (float)_current_num_msgs / _max_num_messages;
+
+	} else {
+		_current_rate_factor = _max_rate_factor;
 	}
 
-	return 0;
+	PX4_DEBUG("current rate=%.3f (max=%i, allowed=%i msgs in %.3fs)", (double)_current_rate_factor, _max_num_messages,
+		  _num_messages_allowed, (double)(_rate_calculation_delta_t / 1e6));
+
+	_current_num_msgs = 0;
+	_message_lost = false;
+	_next_rate_check = now + _rate_calculation_delta_t;
 }
 
 void MavlinkULog::initialize()
@@ -247,9 +303,29 @@ void MavlinkULog::handle_ack(mavlink_logging_ack_t ack)
 	lock();
 
 	if (_instance) { // make sure stop() was not called right before
-		if (_wait_for_ack_sequence == ack.sequence) {
-			_ack_received = true;
-			publish_ack(ack.sequence);
+		for (AckedMessage &acked_message : _acked_messages) {
+			if (acked_message.in_use && acked_message.data.msg_sequence == ack.sequence) {
+				// only use first transmissions for the round trip time, the ack of a
+				// retransmitted message could belong to any of the transmissions
+				if (!acked_message.retransmitted) {
+					const float rtt = (float)hrt_elapsed_time(&acked_message.first_sent_time);
+
+					if (_rtt_mean <= 0.f) {
+						_rtt_mean = rtt;
+						_rtt_variation = rtt / 2.f;
+
+					} else {
+						_rtt_variation = 0.75f * _rtt_variation + 0.25f * fabsf(_rtt_mean - rtt);
+						_rtt_mean = 0.875f * _rtt_mean + 0.125f * rtt;
+					}
+				}
+
+				acked_message.in_use = false;
+				_num_acked_in_flight.fetch_sub(1);
+				++_num_acks;
+				publish_ack(ack.sequence);
+				break;
+			}
 		}
 	}
 
@@ -42,6 +42,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <px4_platform_common/atomic.h>
 #include <px4_platform_common/tasks.h>
 #include <px4_platform_common/sem.h>
 #include <drivers/drv_hrt.h>
@@ -119,28 +120,56 @@ private:
 
 	void publish_ack(uint16_t sequence);
 
+	void send_acked(mavlink_channel_t channel, const ulog_stream_s &ulog_data);
+
+	/**
+	 * Retransmission timeout: fixed while at most one acked message is in flight, derived from the
+	 * measured ack round trip time once the logger uses a larger ack window. Call with _lock held.
+	 */
+	hrt_abstime retransmission_timeout() const;
+
+	/** update the rate estimate and the message budget, called every _rate_calculation_delta_t */
+	void update_rate(hrt_abstime now);
+
+	struct AckedMessage {
+		ulog_stream_s data; ///< only written by handle_update()
+		hrt_abstime first_sent_time;
+		hrt_abstime last_sent_time;
+		bool retransmitted;
+		bool in_use;
+	};
+
 	static px4_sem_t _lock;
 	static bool _init;
 	static MavlinkULog *_instance;
 	static constexpr hrt_abstime _rate_calculation_delta_t = 100_ms; ///< rate update interval
+	static constexpr hrt_abstime _min_retransmission_timeout = 10_ms;
 
 	uORB::SubscriptionData<ulog_stream_s> _ulog_stream_sub{ORB_ID(ulog_stream)};
 	uORB::Publication<ulog_stream_ack_s> _ulog_stream_ack_pub{ORB_ID(ulog_stream_ack)};
-	uint16_t _wait_for_ack_sequence;
-	uint8_t _sent_tries = 0;
-	volatile bool _ack_received = false; ///< set to true if a matching ack received
-	hrt_abstime _last_sent_time = 0; ///< last time we sent a message that requires an ack
+
+	AckedMessage _acked_messages[ulog_stream_ack_s::ACK_WINDOW_MAX] {}; ///< messages waiting for an ack (protected by _lock)
+	px4::atomic_int _num_acked_in_flight{0};
+	bool _window_in_use = false; ///< more than one acked message was in flight at once
+	int _num_acks = 0; ///< number of acks within the current time interval (protected by _lock)
+	float _rtt_mean = 0.f; ///< smoothed ack round trip time [us] (protected by _lock)
+	float _rtt_variation = 0.f;
+
+	hrt_abstime _last_sent_time = 0; ///< used as timestamp during initialization
 	bool _waiting_for_initial_ack = false;
 	const uint8_t _target_system;
 	const uint8_t _target_component;
 
 	const float _max_rate_factor; ///< maximum rate percentage at which we're allowed to push data
 	const int _max_num_messages; ///< maximum number of messages we can send within _rate_calculation_delta_t
+	int _num_messages_allowed; ///< current budget within _rate_calculation_delta_t, reduced when messages get lost
+	bool _message_lost = false; ///< a message needed to be retransmitted within the current time interval
 	float _current_rate_factor; ///< currently used rate percentage
 	int _current_num_msgs = 0;  ///< number of messages sent within the current time interval
 	hrt_abstime _next_rate_check; ///< next timestamp at which to update the rate
 
 	perf_counter_t _msg_missed_ulog_stream_perf{perf_alloc(PC_COUNT, MODULE_NAME": ulog_stream messages missed")};
+	perf_counter_t _msg_retransmitted_perf{perf_alloc(PC_COUNT, MODULE_NAME": ulog_stream retransmissions")};
 
 	/* do not allow copying this class */
 	MavlinkULog(const MavlinkULog &) = delete;
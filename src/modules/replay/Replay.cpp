@@ -49,7 +49,10 @@
 #include <lib/parameters/param.h>
 #include <uORB/uORBMessageFields.hpp>
 
+#include <atomic>
 #include <cstring>
+#include <errno.h>
+#include <fcntl.h>
 #include <float.h>
 #include <fstream>
 #include <iostream>
@@ -59,8 +62,13 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
 
 #include <logger/messages.h>
+#include <lib/heatshrink/heatshrink/heatshrink_decoder.h>
 
 #include "Replay.hpp"
 #include "ReplayEkf2.hpp"
@@ -93,6 +101,8 @@ Replay::~Replay()
 	}
 
 	_subscriptions.clear();
+
+	unmapFile();
 }
 
 void *
@@ -121,11 +131,159 @@ Replay::setupReplayFile(const char *file_name)
 {
 	if (_replay_file) {
 		free(_replay_file);
+		_replay_file = nullptr;
+	}
+
+	if (isCompressedLog(file_name)) {
+		// replay operates on the plain ULog stream (it needs to seek), so decompress the whole file first
+		string base_name = file_name;
+
+		if (base_name.size() > 4 && base_name.compare(base_name.size() - 5, 5, ".ulgz") == 0) {
+			base_name.resize(base_name.size() - 5);
+		}
+
+		// never overwrite an existing file (e.g. the original log of a compressed copy), use the first free name
+		string decompressed_file;
+		int fd = -1;
+
+		for (int i = 0; fd < 0 && i < 100; ++i) {
+			decompressed_file = base_name + (i == 0 ? "" : "_" + to_string(i)) + ".ulg";
+			fd = ::open(decompressed_file.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+
+			if (fd < 0 && errno != EEXIST) {
+				break;
+			}
+		}
+
+		if (fd < 0) {
+			PX4_ERR("failed to create a file to decompress %s into (%s)", file_name, strerror(errno));
+			return;
+		}
+
+		::close(fd);
+
+		if (!decompressLog(file_name, decompressed_file.c_str())) {
+			PX4_ERR("failed to decompress %s", file_name);
+			unlink(decompressed_file.c_str());
+			return;
+		}
+
+		PX4_INFO("decompressed log to %s", decompressed_file.c_str());
+		_replay_file = strdup(decompressed_file.c_str());
+		return;
 	}
 
 	_replay_file = strdup(file_name);
 }
 
+bool
+Replay::isCompressedLog(const char *file_name)
+{
+	ifstream file(file_name, ios::in | ios::binary);
+	ulog_compressed_header_s header;
+	file.read((char *)&header, sizeof(header));
+
+	return file && memcmp(header.magic, "ULogZip", sizeof(header.magic)) == 0;
+}
+
+bool
+Replay::decompressLog(const char *file_name, const char *output_file_name)
+{
+	ifstream file(file_name, ios::in | ios::binary);
+	ulog_compressed_header_s header;
+	file.read((char *)&header, sizeof(header));
+
+	if (!file || header.algorithm != ULOG_COMPRESSION_HEATSHRINK) {
+		PX4_ERR("unsupported compressed log");
+		return false;
+	}
+
+	if (header.window_bits != HEATSHRINK_STATIC_WINDOW_BITS || header.lookahead_bits != HEATSHRINK_STATIC_LOOKAHEAD_BITS) {
+		PX4_ERR("unsupported heatshrink config (window: %i, lookahead: %i)", header.window_bits, header.lookahead_bits);
+		return false;
+	}
+
+	ofstream output_file(output_file_name, ios::out | ios::binary | ios::trunc);
+
+	if (!output_file) {
+		PX4_ERR("failed to open %s", output_file_name);
+		return false;
+	}
+
+	heatshrink_decoder hsd;
+	vector<uint8_t> compressed;
+	// one extra byte to detect blocks that decompress to more than announced
+	vector<uint8_t> uncompressed(header.block_size + 1);
+	size_t uncompressed_size = 0;
+
+	auto poll_decoder = [&]() {
+		HSD_poll_res res;
+
+		do {
+			size_t output_size = 0;
+			res = heatshrink_decoder_poll(&hsd, &uncompressed[uncompressed_size], uncompressed.size() - uncompressed_size,
+						      &output_size);
+			uncompressed_size += output_size;
+		} while (res == HSDR_POLL_MORE && uncompressed_size < uncompressed.size());
+
+		return res >= 0;
+	};
+
+	streampos block_start = file.tellg();
+
+	while (true) {
+		block_start = file.tellg();
+		ulog_compressed_block_s block;
+		file.read((char *)&block, sizeof(block));
+
+		if (!file || block.uncompressed_size == 0 || block.uncompressed_size > header.block_size) {
+			break;
+		}
+
+		compressed.resize(block.compressed_size);
+		file.read((char *)compressed.data(), compressed.size());
+
+		if (!file) {
+			break;
+		}
+
+		heatshrink_decoder_reset(&hsd);
+		uncompressed_size = 0;
+		size_t sunk = 0;
+		bool ok = true;
+
+		while (ok && sunk < compressed.size()) {
+			size_t input_size = 0;
+			ok = heatshrink_decoder_sink(&hsd, &compressed[sunk], compressed.size() - sunk, &input_size) >= 0;
+			sunk += input_size;
+			ok = ok && poll_decoder();
+		}
+
+		while (ok && heatshrink_decoder_finish(&hsd) == HSDR_FINISH_MORE && uncompressed_size < uncompressed.size()) {
+			ok = poll_decoder();
+		}
+
+		if (!ok || uncompressed_size != block.uncompressed_size) {
+			break;
+		}
+
+		output_file.write((const char *)uncompressed.data(), uncompressed_size);
+	}
+
+	// anything following the last valid block (e.g. data appended after a crash) is not compressed
+	file.clear();
+	file.seekg(0, ios::end);
+	const streampos file_end = file.tellg();
+
+	if (block_start < file_end) {
+		PX4_INFO("copying %i bytes of trailing data", (int)(file_end - block_start));
+		file.seekg(block_start);
+		output_file << file.rdbuf();
+	}
+
+	return (bool)output_file;
+}
+
 void
 Replay::setParameter(const string &parameter_name, const double parameter_value)
 {
@@ -329,14 +487,17 @@ Replay::readFlagBits(std::ifstream &file, uint16_t msg_size)
 	_read_buffer.reserve(msg_size);
 	uint8_t *message = (uint8_t *)_read_buffer.data();
 	file.read((char *)message, msg_size);
-	//uint8_t *compat_flags = message;
+	uint8_t *compat_flags = message;
 	uint8_t *incompat_flags = message + 8;
 
+	_has_index = compat_flags[0] & ULOG_COMPAT_FLAG0_INDEX_MASK;
+
 	// handle & validate the flags
 	bool contains_appended_data = incompat_flags[0] & ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK;
 	bool has_unknown_incompat_bits = false;
 
-	if (incompat_flags[0] & ~0x1) {
+	if (incompat_flags[0] & ~(ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK | ULOG_INCOMPAT_FLAG0_DATA_DELTA_MASK
+				  | ULOG_INCOMPAT_FLAG0_LAZY_FORMATS_MASK)) {
 		has_unknown_incompat_bits = true;
 	}
 
@@ -548,6 +709,10 @@ Replay::readAndAddSubscription(std::ifstream &file, uint16_t msg_size)
 	streampos cur_pos = file.tellg();
 	subscription->next_read_pos = this_message_pos; //this will be skipped
 
+	if (_mapped_file && msg_id < _message_tables.data.size()) {
+		subscription->message_offsets.swap(_message_tables.data[msg_id]);
+	}
+
 	if (!nextDataMessage(file, *subscription, msg_id)) {
 		delete subscription;
 		return ReadAndAndAddSubResult::kFailure;
@@ -609,6 +774,11 @@ Replay::findFieldOffset(const string &format, const string &field_name, int &off
 bool
 Replay::readAndHandleAdditionalMessages(std::ifstream &file, std::streampos end_position)
 {
+	if (_mapped_file) {
+		handleMappedAdditionalMessages(end_position);
+		return true;
+	}
+
 	ulog_message_header_s message_header;
 
 	while (file.tellg() < end_position) {
@@ -650,6 +820,17 @@ Replay::readAndApplyParameter(std::ifstream &file, uint16_t msg_size)
 		return false;
 	}
 
+	return applyParameter(message, msg_size);
+}
+
+bool
+Replay::applyParameter(const uint8_t *message, uint16_t msg_size)
+{
+	// key length, key and a 4 byte value (int32_t or float)
+	if (msg_size < 1 || 1 + message[0] + sizeof(int32_t) > msg_size) {
+		return false;
+	}
+
 	uint8_t key_len = message[0];
 	string key((char *)message + 1, key_len);
 
@@ -695,6 +876,11 @@ Replay::readDropout(std::ifstream &file, uint16_t msg_size)
 bool
 Replay::nextDataMessage(std::ifstream &file, Subscription &subscription, int msg_id)
 {
+	if (_mapped_file) {
+		nextMappedDataMessage(subscription);
+		return true;
+	}
+
 	ulog_message_header_s message_header;
 	file.seekg(subscription.next_read_pos);
 	//ignore the first message (it's data we already read)
@@ -728,8 +914,10 @@ Replay::nextDataMessage(std::ifstream &file, Subscription &subscription, int msg
 				if (msg_id == file_msg_id) {
 					if (message_header.msg_size == subscription.orb_meta->o_size_no_padding + 2) {
 						subscription.next_read_pos = cur_pos;
-						file.seekg(subscription.timestamp_offset, ios::cur);
-						file.read((char *)&subscription.next_timestamp, sizeof(subscription.next_timestamp));
+						subscription.sample.resize(subscription.orb_meta->o_size_no_padding);
+						file.read((char *)subscription.sample.data(), subscription.sample.size());
+						memcpy(&subscription.next_timestamp, subscription.sample.data() + subscription.timestamp_offset,
+						       sizeof(subscription.next_timestamp));
 						subscription.published = false;
 						done = true;
 
@@ -738,6 +926,31 @@ Replay::nextDataMessage(std::ifstream &file, Subscription &subscription, int msg
 							subscription.orb_meta->o_name, message_header.msg_size,
 							subscription.orb_meta->o_size_no_padding + 2);
 						file.seekg(message_header.msg_size - sizeof(file_msg_id), ios::cur);
+						subscription.sample.clear(); // following deltas cannot be decoded
+					}
+
+				} else { //not the one we are looking for
+					file.seekg(message_header.msg_size - sizeof(file_msg_id), ios::cur);
+				}
+			}
+
+			break;
+
+		case (int)ULogMessageType::DATA_DELTA:
+			file.read((char *)&file_msg_id, sizeof(file_msg_id));
+
+			if (file) {
+				if (msg_id == file_msg_id) {
+					if (readDataDelta(file, subscription, message_header.msg_size - sizeof(file_msg_id))) {
+						subscription.next_read_pos = cur_pos;
+						memcpy(&subscription.next_timestamp, subscription.sample.data() + subscription.timestamp_offset,
+						       sizeof(subscription.next_timestamp));
+						subscription.published = false;
+						done = true;
+
+					} else if (file) {
+						PX4_ERR("cannot decode delta message for %s. Skipping", subscription.orb_meta->o_name);
+						subscription.sample.clear();
 					}
 
 				} else { //not the one we are looking for
@@ -749,6 +962,7 @@ Replay::nextDataMessage(std::ifstream &file, Subscription &subscription, int msg
 
 		case (int)ULogMessageType::REMOVE_LOGGED_MSG: //skip these
 		case (int)ULogMessageType::ADD_LOGGED_MSG:
+		case (int)ULogMessageType::FORMAT:
 		case (int)ULogMessageType::PARAMETER:
 		case (int)ULogMessageType::DROPOUT:
 		case (int)ULogMessageType::INFO:
@@ -756,6 +970,8 @@ Replay::nextDataMessage(std::ifstream &file, Subscription &subscription, int msg
 		case (int)ULogMessageType::SYNC:
 		case (int)ULogMessageType::LOGGING:
 		case (int)ULogMessageType::PARAMETER_DEFAULT:
+		case (int)ULogMessageType::INDEX:
+		case (int)ULogMessageType::INDEX_FOOTER:
 			file.seekg(message_header.msg_size, ios::cur);
 			break;
 
@@ -776,6 +992,509 @@ Replay::nextDataMessage(std::ifstream &file, Subscription &subscription, int msg
 	return file.good();
 }
 
+bool
+Replay::readDataDelta(std::ifstream &file, Subscription &subscription, uint16_t payload_size)
+{
+	_delta_buffer.resize(payload_size);
+	file.read((char *)_delta_buffer.data(), payload_size);
+
+	if (!file) {
+		return false;
+	}
+
+	return applyDataDelta(subscription, _delta_buffer.data(), payload_size);
+}
+
+bool
+Replay::applyDataDelta(Subscription &subscription, const uint8_t *payload, uint16_t payload_size)
+{
+	if (subscription.sample.size() != subscription.orb_meta->o_size_no_padding) {
+		return false;
+	}
+
+	// validate all runs first, so that an invalid message leaves the sample untouched
+	for (int pass = 0; pass < 2; ++pass) {
+		size_t pos = 0;
+
+		while (pos < payload_size) {
+			ulog_message_data_delta_run_s run;
+
+			if (pos + sizeof(run) > payload_size) {
+				return false;
+			}
+
+			memcpy(&run, payload + pos, sizeof(run));
+			pos += sizeof(run);
+
+			if (pos + run.length > payload_size || run.offset + run.length > subscription.sample.size()) {
+				return false;
+			}
+
+			if (pass == 1) {
+				for (int i = 0; i < run.length; ++i) {
+					subscription.sample[run.offset + i] ^= payload[pos + i];
+				}
+			}
+
+			pos += run.length;
+		}
+	}
+
+	return true;
+}
+
+bool
+Replay::mapFile(const char *file_name)
+{
+	const char *use_mmap = getenv(replay::ENV_MMAP);
+
+	if (use_mmap && strcmp(use_mmap, "0") == 0) {
+		return false;
+	}
+
+	int fd = ::open(file_name, O_RDONLY);
+
+	if (fd < 0) {
+		return false;
+	}
+
+	struct stat st;
+	void *mapped = MAP_FAILED;
+
+	if (fstat(fd, &st) == 0 && st.st_size > 0) {
+		_mapped_size = std::min<int64_t>(st.st_size, _read_until_file_position);
+		mapped = mmap(nullptr, _mapped_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	}
+
+	// the mapping stays valid after closing the file
+	::close(fd);
+
+	if (mapped == MAP_FAILED) {
+		PX4_WARN("failed to map the log (%s), reading it via streams", strerror(errno));
+		_mapped_size = 0;
+		return false;
+	}
+
+	// per-topic cursors move forward at roughly the same time, so the overall access pattern is sequential
+	madvise(mapped, _mapped_size, MADV_SEQUENTIAL);
+	_mapped_file = (const uint8_t *)mapped;
+	return true;
+}
+
+void
+Replay::unmapFile()
+{
+	if (_mapped_file) {
+		munmap((void *)_mapped_file, _mapped_size);
+		_mapped_file = nullptr;
+		_mapped_size = 0;
+	}
+
+	_message_tables.data.clear();
+	_message_tables.additional.clear();
+	_next_additional_message = 0;
+}
+
+uint64_t
+Replay::findSyncMessage(uint64_t start, uint64_t end) const
+{
+	// message header (msg_size 8, SYNC) followed by the sync magic
+	const uint8_t pattern[ULOG_MSG_HEADER_LEN + 8] = {8, 0, (uint8_t)ULogMessageType::SYNC,
+							   0x2F, 0x73, 0x13, 0x20, 0x25, 0x0C, 0xBB, 0x12
+							  };
+
+	if (end <= start) {
+		return end;
+	}
+
+	// the pattern can also appear within message data (very unlikely with 11 bytes), buildMessageTables() checks
+	// that the parts are contiguous
+	const void *found = memmem(_mapped_file + start, end - start, pattern, sizeof(pattern));
+
+	return found ? (const uint8_t *)found - _mapped_file : end;
+}
+
+uint64_t
+Replay::indexMessages(uint64_t start, uint64_t end, MessageTables &tables) const
+{
+	uint64_t offset = start;
+
+	while (offset < end && offset + ULOG_MSG_HEADER_LEN <= _mapped_size) {
+		ulog_message_header_s message_header;
+		memcpy(&message_header, _mapped_file + offset, ULOG_MSG_HEADER_LEN);
+		const uint64_t message_end = offset + ULOG_MSG_HEADER_LEN + message_header.msg_size;
+
+		if (message_end > _mapped_size) {
+			break;
+		}
+
+		switch (message_header.msg_type) {
+		case (int)ULogMessageType::DATA:
+		case (int)ULogMessageType::DATA_DELTA:
+			if (message_header.msg_size >= sizeof(uint16_t)) {
+				uint16_t msg_id;
+				memcpy(&msg_id, _mapped_file + offset + ULOG_MSG_HEADER_LEN, sizeof(msg_id));
+
+				if (tables.data.size() <= msg_id) {
+					tables.data.resize(msg_id + 1);
+				}
+
+				tables.data[msg_id].push_back(offset);
+			}
+
+			break;
+
+		case (int)ULogMessageType::PARAMETER:
+		case (int)ULogMessageType::DROPOUT:
+			tables.additional.push_back(offset);
+			break;
+
+		default:
+			break;
+		}
+
+		offset = message_end;
+	}
+
+	return offset;
+}
+
+void
+Replay::buildMessageTables()
+{
+	const hrt_abstime start_time = hrt_absolute_time();
+	const uint64_t data_start = _data_section_start;
+	const uint64_t data_end = _mapped_size;
+
+	// split the data section into parts starting at SYNC messages (written every 0.5s), so that each part can be
+	// indexed independently. Parts are small enough to balance the load, but large enough to amortize the search.
+	static constexpr uint64_t min_part_size = 16 * 1024 * 1024;
+	unsigned num_threads = std::max(1u, std::thread::hardware_concurrency());
+	size_t num_parts = 1;
+
+	if (data_end > data_start) {
+		num_parts = std::min<uint64_t>(num_threads * 4, (data_end - data_start) / min_part_size + 1);
+	}
+
+	std::vector<uint64_t> part_start(num_parts + 1);
+	part_start[0] = data_start;
+	part_start[num_parts] = data_end;
+
+	for (size_t i = 1; i < num_parts; ++i) {
+		const uint64_t nominal_start = data_start + (data_end - data_start) * i / num_parts;
+		part_start[i] = findSyncMessage(std::max(nominal_start, part_start[i - 1]), data_end);
+	}
+
+	std::vector<MessageTables> part_tables(num_parts);
+	std::vector<uint64_t> part_end(num_parts);
+	std::atomic<size_t> next_part{0};
+
+	auto index_parts = [&]() {
+		for (size_t part = next_part++; part < num_parts; part = next_part++) {
+			part_end[part] = indexMessages(part_start[part], part_start[part + 1], part_tables[part]);
+		}
+	};
+
+	num_threads = std::min<size_t>(num_threads, num_parts);
+	std::vector<std::thread> threads;
+
+	for (unsigned i = 1; i < num_threads; ++i) {
+		threads.emplace_back(index_parts);
+	}
+
+	index_parts();
+
+	for (auto &thread : threads) {
+		thread.join();
+	}
+
+	// a part only starts at a message boundary if the previous one ends there, otherwise its SYNC was found within
+	// message data: index it again sequentially from where the previous part actually ends
+	unsigned num_reindexed = 0;
+
+	for (size_t part = 1; part < num_parts; ++part) {
+		if (part_end[part - 1] != part_start[part]) {
+			part_tables[part] = MessageTables{};
+			part_start[part] = part_end[part - 1];
+			part_end[part] = indexMessages(part_start[part], part_start[part + 1], part_tables[part]);
+			++num_reindexed;
+		}
+	}
+
+	if (num_reindexed > 0) {
+		PX4_WARN("%u log parts did not start at a message boundary, indexed them again", num_reindexed);
+	}
+
+	// concatenate the parts (in file order)
+	size_t max_msg_ids = 0;
+
+	for (const auto &tables : part_tables) {
+		max_msg_ids = std::max(max_msg_ids, tables.data.size());
+	}
+
+	_message_tables.data.resize(max_msg_ids);
+	size_t num_messages = 0;
+
+	for (size_t msg_id = 0; msg_id < max_msg_ids; ++msg_id) {
+		std::vector<uint64_t> &offsets = _message_tables.data[msg_id];
+		size_t num_offsets = 0;
+
+		for (const auto &tables : part_tables) {
+			num_offsets += msg_id < tables.data.size() ? tables.data[msg_id].size() : 0;
+		}
+
+		offsets.reserve(num_offsets);
+
+		for (auto &tables : part_tables) {
+			if (msg_id < tables.data.size()) {
+				offsets.insert(offsets.end(), tables.data[msg_id].begin(), tables.data[msg_id].end());
+				std::vector<uint64_t>().swap(tables.data[msg_id]);
+			}
+		}
+
+		num_messages += num_offsets;
+	}
+
+	for (const auto &tables : part_tables) {
+		_message_tables.additional.insert(_message_tables.additional.end(), tables.additional.begin(),
+						  tables.additional.end());
+	}
+
+	_next_additional_message = 0;
+
+	PX4_INFO("Indexed %zu data messages in %.3lf s (%zu parts, %u threads)", num_messages,
+		 (double)hrt_elapsed_time(&start_time) / 1.e6, num_parts, num_threads);
+}
+
+void
+Replay::nextMappedDataMessage(Subscription &subscription)
+{
+	while (subscription.next_message < subscription.message_offsets.size()) {
+		const uint64_t offset = subscription.message_offsets[subscription.next_message++];
+		ulog_message_header_s message_header;
+		memcpy(&message_header, _mapped_file + offset, ULOG_MSG_HEADER_LEN);
+		const uint8_t *payload = _mapped_file + offset + ULOG_MSG_HEADER_LEN + sizeof(uint16_t);
+		const uint16_t payload_size = message_header.msg_size - sizeof(uint16_t);
+
+		if (message_header.msg_type == (int)ULogMessageType::DATA) {
+			if (payload_size != subscription.orb_meta->o_size_no_padding) { //sanity check failed!
+				PX4_ERR("data message %s has wrong size %i (expected %i). Skipping",
+					subscription.orb_meta->o_name, message_header.msg_size,
+					subscription.orb_meta->o_size_no_padding + 2);
+				subscription.sample.clear(); // following deltas cannot be decoded
+				continue;
+			}
+
+			subscription.sample.assign(payload, payload + payload_size);
+
+		} else if (!applyDataDelta(subscription, payload, payload_size)) {
+			PX4_ERR("cannot decode delta message for %s. Skipping", subscription.orb_meta->o_name);
+			subscription.sample.clear();
+			continue;
+		}
+
+		subscription.next_read_pos = offset;
+		memcpy(&subscription.next_timestamp, subscription.sample.data() + subscription.timestamp_offset,
+		       sizeof(subscription.next_timestamp));
+		subscription.published = false;
+		return;
+	}
+
+	//no more data messages for this subscription
+	subscription.orb_meta = nullptr;
+}
+
+void
+Replay::handleMappedAdditionalMessages(uint64_t end_position)
+{
+	const std::vector<uint64_t> &offsets = _message_tables.additional;
+
+	for (; _next_additional_message < offsets.size() && offsets[_next_additional_message] < end_position;
+	     ++_next_additional_message) {
+		const uint64_t offset = offsets[_next_additional_message];
+		ulog_message_header_s message_header;
+		memcpy(&message_header, _mapped_file + offset, ULOG_MSG_HEADER_LEN);
+		const uint8_t *message = _mapped_file + offset + ULOG_MSG_HEADER_LEN;
+
+		if (message_header.msg_type == (int)ULogMessageType::PARAMETER) {
+			applyParameter(message, message_header.msg_size);
+
+		} else if (message_header.msg_size >= sizeof(uint16_t)) {
+			uint16_t duration;
+			memcpy(&duration, message, sizeof(duration));
+			PX4_ERR("Dropout in replayed log, %i ms", (int)duration);
+		}
+	}
+}
+
+int64_t
+Replay::findLastIndex(std::ifstream &file)
+{
+	file.clear();
+	file.seekg(0, ios::end);
+	const int64_t end = std::min((int64_t)file.tellg(), _read_until_file_position);
+
+	// a log that was closed properly ends with the footer
+	ulog_message_index_footer_s footer;
+
+	if (end >= (int64_t)sizeof(footer)) {
+		file.seekg(end - sizeof(footer));
+		file.read((char *)&footer, sizeof(footer));
+
+		if (file && footer.msg_type == (uint8_t)ULogMessageType::INDEX_FOOTER
+		    && footer.msg_size == sizeof(footer) - ULOG_MSG_HEADER_LEN && memcmp(footer.magic, "ULogIdx", 7) == 0
+		    && (int64_t)footer.index_offset < end) {
+			return footer.index_offset;
+		}
+	}
+
+	// otherwise search backwards for an index message that contains its own offset
+	static constexpr int64_t chunk_size = 64 * 1024;
+	static constexpr int64_t max_search_size = 64 * 1024 * 1024;
+	std::vector<uint8_t> chunk(chunk_size + sizeof(ulog_message_index_s));
+	const int64_t search_end = std::max(end - max_search_size, (int64_t)_data_section_start);
+
+	for (int64_t chunk_end = end; chunk_end > search_end; chunk_end -= chunk_size) {
+		const int64_t chunk_start = std::max(chunk_end - chunk_size, search_end);
+		const int64_t read_size = std::min(end - chunk_start, (int64_t)chunk.size());
+		file.clear();
+		file.seekg(chunk_start);
+		file.read((char *)chunk.data(), read_size);
+
+		if (!file) {
+			return -1;
+		}
+
+		for (int64_t pos = chunk_end - chunk_start - 1; pos >= 0; --pos) {
+			ulog_message_index_s index;
+
+			if (pos + (int64_t)sizeof(index) > read_size || chunk[pos + 2] != (uint8_t)ULogMessageType::INDEX) {
+				continue;
+			}
+
+			memcpy(&index, &chunk[pos], sizeof(index));
+
+			if (index.offset == (uint64_t)(chunk_start + pos) && chunk_start + pos + ULOG_MSG_HEADER_LEN + index.msg_size <= end) {
+				return index.offset;
+			}
+		}
+	}
+
+	return -1;
+}
+
+bool
+Replay::readIndex(std::ifstream &file, std::vector<uint64_t> &definition_offsets, int64_t &last_index_offset)
+{
+	last_index_offset = findLastIndex(file);
+
+	if (last_index_offset < 0) {
+		return false;
+	}
+
+	definition_offsets.clear();
+	int64_t offset = last_index_offset;
+
+	while (offset > 0) {
+		ulog_message_index_s index;
+		file.clear();
+		file.seekg(offset);
+		file.read((char *)&index, sizeof(index));
+
+		if (!file || index.msg_type != (uint8_t)ULogMessageType::INDEX || index.offset != (uint64_t)offset
+		    || (size_t)index.msg_size + ULOG_MSG_HEADER_LEN < sizeof(index)) {
+			PX4_WARN("invalid index message at offset %" PRIi64, offset);
+			return false;
+		}
+
+		const int num_entries = (index.msg_size + ULOG_MSG_HEADER_LEN - sizeof(index)) / sizeof(ulog_message_index_entry_s);
+
+		for (int i = 0; i < num_entries; ++i) {
+			ulog_message_index_entry_s entry;
+			file.read((char *)&entry, sizeof(entry));
+
+			if (!file) {
+				return false;
+			}
+
+			if (entry.msg_type == (uint8_t)ULogMessageType::ADD_LOGGED_MSG
+			    || entry.msg_type == (uint8_t)ULogMessageType::FORMAT) {
+				definition_offsets.push_back(entry.offset);
+			}
+		}
+
+		// the chain must go backwards
+		if ((int64_t)index.previous_index_offset >= offset) {
+			return false;
+		}
+
+		offset = index.previous_index_offset;
+	}
+
+	std::sort(definition_offsets.begin(), definition_offsets.end());
+	return true;
+}
+
+void
+Replay::addSubscriptions(std::ifstream &file)
+{
+	ulog_message_header_s message_header;
+	std::vector<uint64_t> definition_offsets;
+	int64_t scan_start = _data_section_start;
+
+	if (_has_index && readIndex(file, definition_offsets, scan_start)) {
+		PX4_INFO("Using the log index (%zu definitions)", definition_offsets.size());
+
+		for (uint64_t offset : definition_offsets) {
+			file.clear();
+			file.seekg(offset);
+			file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
+
+			if (!file) {
+				continue;
+			}
+
+			if (message_header.msg_type == (int)ULogMessageType::ADD_LOGGED_MSG) {
+				readAndAddSubscription(file, message_header.msg_size);
+
+			} else if (message_header.msg_type == (int)ULogMessageType::FORMAT) {
+				readFormat(file, message_header.msg_size);
+			}
+		}
+
+	} else {
+		scan_start = _data_section_start;
+	}
+
+	// scan the part that is not indexed (the whole data section without index)
+	file.clear();
+	file.seekg(scan_start);
+
+	while (true) {
+		//we are in the Definition & Data Section Message Header section
+		file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
+
+		if (!file) {
+			// end of file
+			break;
+		}
+
+		if (message_header.msg_type == (int)ULogMessageType::ADD_LOGGED_MSG) {
+			readAndAddSubscription(file, message_header.msg_size);
+
+		} else if (message_header.msg_type == (int)ULogMessageType::FORMAT) {
+			// lazy formats: written right before the first subscription using them
+			if (!readFormat(file, message_header.msg_size)) {
+				break;
+			}
+
+		} else {
+			// Not important for now, skip
+			file.seekg(message_header.msg_size, ios::cur);
+		}
+	}
+}
+
 const orb_metadata *
 Replay::findTopic(const std::string &name)
 {
@@ -902,28 +1621,13 @@ Replay::run()
 
 	PX4_INFO("Replay in progress...");
 
-	// Find and add all subscriptions
-	ulog_message_header_s message_header;
-	replay_file.seekg(_data_section_start);
-
-	while (true) {
-		//we are in the Definition & Data Section Message Header section
-		replay_file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
-
-		if (!replay_file) {
-			// end of file
-			break;
-		}
-
-		if (message_header.msg_type == (int)ULogMessageType::ADD_LOGGED_MSG) {
-			readAndAddSubscription(replay_file, message_header.msg_size);
-
-		} else {
-			// Not important for now, skip
-			replay_file.seekg(message_header.msg_size, ios::cur);
-		}
+	// with a memory-mapped log, all messages are located upfront and the main loop does not access the file anymore
+	if (mapFile(_replay_file)) {
+		buildMessageTables();
 	}
 
+	addSubscriptions(replay_file);
+
 	// Rewind back to the begining of the data section
 	replay_file.seekg(_data_section_start);
 	replay_file.clear();
@@ -969,7 +1673,10 @@ Replay::run()
 		}
 
 		//handle additional messages between last and next published data
-		replay_file.seekg(last_additional_message_pos);
+		if (!_mapped_file) {
+			replay_file.seekg(last_additional_message_pos);
+		}
+
 		streampos next_additional_message_pos = sub.next_read_pos;
 		readAndHandleAdditionalMessages(replay_file, next_additional_message_pos);
 		last_additional_message_pos = next_additional_message_pos;
@@ -1023,6 +1730,8 @@ Replay::run()
 
 	onExitMainLoop();
 
+	unmapFile();
+
 	if (!should_exit()) {
 		replay_file.close();
 		px4_shutdown_request();
@@ -1041,11 +1750,10 @@ Replay::run()
 void
 Replay::readTopicDataToBuffer(const Subscription &sub, std::ifstream &replay_file)
 {
-	const size_t msg_read_size = sub.orb_meta->o_size_no_padding;
 	const size_t msg_write_size = sub.orb_meta->o_size;
 	_read_buffer.reserve(msg_write_size);
-	replay_file.seekg(sub.next_read_pos + (streamoff)(ULOG_MSG_HEADER_LEN + 2)); //skip header & msg id
-	replay_file.read((char *)_read_buffer.data(), msg_read_size);
+	// the data was already read (and decoded) when searching the message
+	memcpy(_read_buffer.data(), sub.sample.data(), sub.sample.size());
 }
 
 bool
@@ -1245,6 +1953,12 @@ the log file to be replayed. The second is the mode, specified via `replay_mode`
 - Generic otherwise: this can be used to replay any module(s), but the replay will be done with the same speed as the
   log was recorded.
 
+The log is memory-mapped and the offsets of all messages are collected in parallel before the replay starts. Set
+`replay_mmap=0` to read the log via file streams instead.
+
+Compressed logs (`.ulgz`, see `SDLOG_COMPRESS`) are decompressed into a regular `.ulg` file next to the original
+before the replay starts.
+
 The module is typically used together with uORB publisher rules, to specify which messages should be replayed.
 The replay module will just publish all messages that are found in the log. It also applies the parameters from
 the log.
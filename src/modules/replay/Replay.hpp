@@ -88,6 +88,7 @@ public:
 	 * Tell the replay module that we want to use replay mode.
 	 * After that, only 'replay start' must be executed (typically the last step after startup).
 	 * @param file_name file name of the used log replay file. Will be copied.
+	 *                  Compressed logs are decompressed into a regular ULog file next to it.
 	 */
 	static void setupReplayFile(const char *file_name);
 
@@ -136,6 +137,10 @@ protected:
 
 		std::streampos next_read_pos;
 		uint64_t next_timestamp; ///< timestamp of the file
+		std::vector<uint8_t> sample; ///< data of the message at next_read_pos (decoded if delta encoded)
+
+		std::vector<uint64_t> message_offsets; ///< file offsets of all data messages (only for a memory-mapped log)
+		size_t next_message = 0; ///< index into message_offsets of the message following next_read_pos
 
 		CompatBase *compat = nullptr;
 
@@ -249,10 +254,96 @@ private:
 
 	int64_t _read_until_file_position = 1ULL << 60; ///< read limit if log contains appended data
 
+	bool _has_index{false}; ///< the log contains INDEX messages (written with SDLOG_INDEX)
+
 	float _accumulated_delay{0.f};
 
 	bool readFileHeader(std::ifstream &file);
 
+	/**
+	 * Apply a DATA_DELTA message to the subscription's sample.
+	 * @param payload_size size of the message after the msg_id
+	 * @return true on success, false if the message is invalid or there is no previous sample
+	 */
+	bool readDataDelta(std::ifstream &file, Subscription &subscription, uint16_t payload_size);
+	bool applyDataDelta(Subscription &subscription, const uint8_t *payload, uint16_t payload_size);
+
+	/**
+	 * Memory-map the log file (up to _read_until_file_position).
+	 * @return false if mapping is disabled (ENV_MMAP) or failed, in which case the file is read via streams
+	 */
+	bool mapFile(const char *file_name);
+	void unmapFile();
+
+	/**
+	 * Build the per-msg_id tables of data message offsets and the table of additional messages (parameters,
+	 * dropouts) from the mapped file. The data section is split at SYNC messages and the parts are indexed in parallel.
+	 * A part that does not start where the previous one actually ends (the SYNC pattern was found within message
+	 * data) is indexed again sequentially from there.
+	 */
+	void buildMessageTables();
+
+	/**
+	 * Find the first SYNC message in [start, end) of the mapped file.
+	 * @return offset of the message (usually a message boundary, the pattern can also appear within message data),
+	 * or end if not found
+	 */
+	uint64_t findSyncMessage(uint64_t start, uint64_t end) const;
+
+	struct MessageTables {
+		std::vector<std::vector<uint64_t>> data; ///< data message offsets, indexed by msg_id
+		std::vector<uint64_t> additional; ///< PARAMETER and DROPOUT message offsets
+	};
+
+	/**
+	 * Collect the offsets of all messages starting in [start, end) of the mapped file. start must be a message boundary.
+	 * @return end offset of the last indexed message (the next message boundary)
+	 */
+	uint64_t indexMessages(uint64_t start, uint64_t end, MessageTables &tables) const;
+
+	/** nextDataMessage() for a memory-mapped log: decode the next message from the subscription's table */
+	void nextMappedDataMessage(Subscription &subscription);
+
+	/** readAndHandleAdditionalMessages() for a memory-mapped log */
+	void handleMappedAdditionalMessages(uint64_t end_position);
+
+	const uint8_t *_mapped_file{nullptr}; ///< memory-mapped log, nullptr if the log is read via streams
+	size_t _mapped_size{0};
+	MessageTables _message_tables; ///< data tables are moved into the subscriptions when they are added
+	size_t _next_additional_message{0}; ///< index into _message_tables.additional
+
+	/**
+	 * Find the last INDEX message, either via the footer or (for a truncated log) by searching backwards from the end.
+	 * @return file offset of the last index message, or -1 if not found
+	 */
+	int64_t findLastIndex(std::ifstream &file);
+
+	/**
+	 * Read the ADD_LOGGED_MSG and FORMAT offsets from the chain of index messages, starting with the last one.
+	 * @param definition_offsets sorted file offsets of all indexed ADD_LOGGED_MSG and FORMAT messages
+	 * @param last_index_offset file offset of the last index message: messages after it are not indexed
+	 * @return false if the log has no (valid) index
+	 */
+	bool readIndex(std::ifstream &file, std::vector<uint64_t> &definition_offsets, int64_t &last_index_offset);
+
+	/**
+	 * Add the subscriptions of all ADD_LOGGED_MSG messages, using the index if the log has one.
+	 * FORMAT messages in the data section (logged with lazy formats) are read as well.
+	 */
+	void addSubscriptions(std::ifstream &file);
+
+	std::vector<uint8_t> _delta_buffer; ///< DATA_DELTA message payload
+
+	/** check if a file is a compressed log (written with SDLOG_COMPRESS) */
+	static bool isCompressedLog(const char *file_name);
+
+	/**
+	 * Decompress a compressed log into a regular ULog file.
+	 * Trailing data that is not a complete compressed block is copied as-is.
+	 * @return true on success
+	 */
+	static bool decompressLog(const char *file_name, const char *output_file_name);
+
 	/**
 	 * Read definitions section: check formats, apply parameters and store
 	 * the start of the data section.
@@ -283,6 +374,7 @@ private:
 	bool readAndHandleAdditionalMessages(std::ifstream &file, std::streampos end_position);
 	bool readDropout(std::ifstream &file, uint16_t msg_size);
 	bool readAndApplyParameter(std::ifstream &file, uint16_t msg_size);
+	bool applyParameter(const uint8_t *message, uint16_t msg_size);
 
 	static const orb_metadata *findTopic(const std::string &name);
 
@@ -43,6 +43,7 @@
 #include <unistd.h>
 
 #include <drivers/drv_hrt.h>
+#include <mathlib/mathlib.h>
 #include <perf/perf_counter.h>
 #include <px4_platform_common/px4_config.h>
 #include <px4_platform_common/micro_hal.h>
@@ -94,9 +95,26 @@ public:
 private:
 
 	bool time_px4_hrt();
+	bool time_px4_hrt_jitter();
 
 	void reset();
 
+	/**
+	 * Run a periodic callout for one second and print the deviation of the
+	 * actual from the scheduled call times.
+	 */
+	bool measure_jitter(const char *backend, unsigned rate_hz);
+
+	static void jitter_callout(void *arg);
+
+	static constexpr unsigned MAX_JITTER_SAMPLES = 4000;
+
+	struct hrt_call _jitter_call {};
+	hrt_abstime _jitter_start{0};
+	hrt_abstime _jitter_interval{0};
+	volatile unsigned _jitter_count{0};
+	uint32_t _jitter_samples[MAX_JITTER_SAMPLES] {};
+
 	void lock()
 	{
 #ifdef __PX4_NUTTX
@@ -118,6 +136,7 @@ private:
 bool MicroBenchHRT::run_tests()
 {
 	ut_run_test(time_px4_hrt);
+	ut_run_test(time_px4_hrt_jitter);
 
 	return (_tests_failed == 0);
 }
@@ -148,4 +167,99 @@ bool MicroBenchHRT::time_px4_hrt()
 	return true;
 }
 
+void MicroBenchHRT::jitter_callout(void *arg)
+{
+	MicroBenchHRT *self = static_cast<MicroBenchHRT *>(arg);
+	const hrt_abstime now = hrt_absolute_time();
+
+	if (self->_jitter_count < MAX_JITTER_SAMPLES) {
+		// periodic calls are scheduled relative to the first deadline, so they don't drift
+		const hrt_abstime scheduled = self->_jitter_start + self->_jitter_count * self->_jitter_interval;
+		self->_jitter_samples[self->_jitter_count] = (now > scheduled) ? now - scheduled : scheduled - now;
+		self->_jitter_count = self->_jitter_count + 1;
+	}
+}
+
+static int compare_uint32(const void *a, const void *b)
+{
+	const uint32_t l = *(const uint32_t *)a;
+	const uint32_t r = *(const uint32_t *)b;
+	return (l > r) - (l < r);
+}
+
+bool MicroBenchHRT::measure_jitter(const char *backend, unsigned rate_hz)
+{
+	const unsigned samples = math::min(rate_hz, MAX_JITTER_SAMPLES);
+
+	const hrt_abstime timeout = hrt_absolute_time() + 2000000;
+
+	_jitter_interval = 1000000 / rate_hz;
+	_jitter_count = 0;
+	hrt_call_every(&_jitter_call, 10000, _jitter_interval, &jitter_callout, this);
+
+	// the first call is 10 ms ahead, so its deadline can be read safely
+	_jitter_start = _jitter_call.deadline;
+
+	while ((_jitter_count < samples) && (hrt_absolute_time() < timeout)) {
+		px4_usleep(10000);
+	}
+
+	hrt_cancel(&_jitter_call);
+
+	const unsigned count = math::min((unsigned)_jitter_count, samples);
+
+	if (count == 0) {
+		PX4_ERR("%s %u Hz: no callouts", backend, rate_hz);
+		return false;
+	}
+
+	uint64_t sum = 0;
+
+	for (unsigned i = 0; i < count; i++) {
+		sum += _jitter_samples[i];
+	}
+
+	qsort(_jitter_samples, count, sizeof(_jitter_samples[0]), compare_uint32);
+
+	PX4_INFO_RAW("%-10s %4u Hz: %4u samples, mean %6.1f us, p99 %5" PRIu32 " us, max %5" PRIu32 " us\n",
+		     backend, rate_hz, count, (double)sum / count, _jitter_samples[(count * 99) / 100],
+		     _jitter_samples[count - 1]);
+
+	return true;
+}
+
+bool MicroBenchHRT::time_px4_hrt_jitter()
+{
+	static constexpr unsigned rates[] {400, 1000, 4000};
+	bool ret = true;
+
+#if defined(__PX4_LINUX)
+	// compare the HRT work queue thread and the timerfd backend
+	const bool timerfd_default = hrt_timerfd_backend();
+
+	static constexpr bool backends[] {false, true};
+
+	for (bool timerfd : backends) {
+		if (hrt_set_timerfd_backend(timerfd) != PX4_OK) {
+			PX4_INFO_RAW("%s timer not available\n", timerfd ? "timerfd" : "hrt_work");
+			continue;
+		}
+
+		for (unsigned rate : rates) {
+			ret = measure_jitter(timerfd ? "timerfd" : "hrt_work", rate) && ret;
+		}
+	}
+
+	hrt_set_timerfd_backend(timerfd_default);
+#else
+
+	for (unsigned rate : rates) {
+		ret = measure_jitter("hrt", rate) && ret;
+	}
+
+#endif // __PX4_LINUX
+
+	return ret;
+}
+
 } // namespace MicroBenchHRT
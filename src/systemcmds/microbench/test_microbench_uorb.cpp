@@ -38,16 +38,25 @@
 
 #include <unit_test.h>
 
+#include <pthread.h>
 #include <time.h>
 #include <stdlib.h>
 #include <unistd.h>
 
 #include <drivers/drv_hrt.h>
 #include <perf/perf_counter.h>
+#include <px4_platform_common/atomic.h>
 #include <px4_platform_common/px4_config.h>
 #include <px4_platform_common/micro_hal.h>
 
+#include <uORB/Publication.hpp>
 #include <uORB/Subscription.hpp>
+#include <uORB/topics/uORBTopics.hpp>
+#include <uORB/topics/orb_test_large.h>
+#include <uORB/topics/orb_test_loan_large.h>
+#include <uORB/topics/orb_test_loan_medium.h>
+#include <uORB/topics/orb_test_loan_small.h>
+#include <uORB/topics/orb_test_medium.h>
 #include <uORB/topics/sensor_accel.h>
 #include <uORB/topics/sensor_gyro.h>
 #include <uORB/topics/sensor_gyro_fifo.h>
@@ -102,6 +111,17 @@ private:
 
 	bool time_px4_uorb();
 	bool time_px4_uorb_direct();
+	bool time_px4_uorb_loan();
+	bool time_px4_uorb_subscribe_all();
+
+	template<typename T>
+	void loan_vs_copy(const orb_metadata *meta);
+#if defined(__PX4_POSIX)
+	bool time_px4_uorb_contended();
+
+	template<typename T>
+	void publish_with_readers(const orb_metadata *meta, int num_readers);
+#endif // __PX4_POSIX
 
 	void reset();
 
@@ -115,6 +135,11 @@ bool MicroBenchORB::run_tests()
 {
 	ut_run_test(time_px4_uorb);
 	ut_run_test(time_px4_uorb_direct);
+	ut_run_test(time_px4_uorb_loan);
+	ut_run_test(time_px4_uorb_subscribe_all);
+#if defined(__PX4_POSIX)
+	ut_run_test(time_px4_uorb_contended);
+#endif // __PX4_POSIX
 
 	return (_tests_failed == 0);
 }
@@ -246,4 +271,233 @@ bool MicroBenchORB::time_px4_uorb_direct()
 	return true;
 }
 
+static void print_throughput(const char *name, const orb_metadata *meta, hrt_abstime elapsed, int count)
+{
+	const float us_per_op = (float)elapsed / count;
+	const float mbytes_per_s = (elapsed > 0) ? ((float)meta->o_size * count) / elapsed : 0.f;
+	printf("%-24s %-10s %5u B: %8.3f us/op %10.1f MB/s\n", meta->o_name, name, (unsigned)meta->o_size, (double)us_per_op,
+	       (double)mbytes_per_s);
+}
+
+template<typename T>
+void MicroBenchORB::loan_vs_copy(const orb_metadata *meta)
+{
+	static constexpr int COUNT = 10000;
+
+	uORB::Publication<T> pub{meta};
+	uORB::Subscription sub{meta};
+
+	T data{};
+	pub.publish(data);
+
+	volatile int32_t sink = 0;
+
+	hrt_abstime start = hrt_absolute_time();
+
+	for (int i = 0; i < COUNT; i++) {
+		data.val = i;
+		data.junk[i % sizeof(data.junk)] = i;
+		pub.publish(data);
+	}
+
+	print_throughput("publish", meta, hrt_elapsed_time(&start), COUNT);
+
+	start = hrt_absolute_time();
+
+	for (int i = 0; i < COUNT; i++) {
+		T *msg = pub.loan();
+
+		if (msg == nullptr) {
+			printf("%s: loan not supported\n", meta->o_name);
+			break;
+		}
+
+		msg->val = i;
+		msg->junk[i % sizeof(msg->junk)] = i;
+		pub.commit();
+	}
+
+	print_throughput("loan", meta, hrt_elapsed_time(&start), COUNT);
+
+	start = hrt_absolute_time();
+
+	for (int i = 0; i < COUNT; i++) {
+		sub.copy(&data);
+		sink = data.val + data.junk[i % sizeof(data.junk)];
+	}
+
+	print_throughput("copy", meta, hrt_elapsed_time(&start), COUNT);
+
+	start = hrt_absolute_time();
+
+	for (int i = 0; i < COUNT; i++) {
+		const T *msg = static_cast<const T *>(sub.borrow());
+
+		if (msg == nullptr) {
+			printf("%s: borrow not supported\n", meta->o_name);
+			break;
+		}
+
+		const int32_t val = msg->val + msg->junk[i % sizeof(msg->junk)];
+
+		if (sub.release()) {
+			sink = val;
+		}
+	}
+
+	print_throughput("borrow", meta, hrt_elapsed_time(&start), COUNT);
+
+	(void)sink;
+	printf("\n");
+}
+
+bool MicroBenchORB::time_px4_uorb_loan()
+{
+	loan_vs_copy<orb_test_loan_small_s>(ORB_ID(orb_test_loan_small));
+	loan_vs_copy<orb_test_loan_medium_s>(ORB_ID(orb_test_loan_medium));
+	loan_vs_copy<orb_test_loan_large_s>(ORB_ID(orb_test_loan_large));
+
+	return true;
+}
+
+bool MicroBenchORB::time_px4_uorb_subscribe_all()
+{
+	// cold start: check and subscribe every instance of every topic once, like a module startup or the logger
+	const orb_metadata *const *topics = orb_get_topics();
+
+	perf_counter_t exists_perf = perf_alloc(PC_ELAPSED, "uORB: orb_exists (all topics)");
+	perf_counter_t subscribe_perf = perf_alloc(PC_ELAPSED, "uORB: Subscription subscribe (existing)");
+
+	int num_exists = 0;
+	const hrt_abstime start = hrt_absolute_time();
+
+	for (size_t i = 0; i < orb_topics_count(); i++) {
+		for (uint8_t instance = 0; instance < ORB_MULTI_MAX_INSTANCES; instance++) {
+			perf_begin(exists_perf);
+			const bool exists = (orb_exists(topics[i], instance) == PX4_OK);
+			perf_end(exists_perf);
+
+			if (exists) {
+				num_exists++;
+
+				uORB::Subscription sub{topics[i], instance};
+
+				perf_begin(subscribe_perf);
+				sub.subscribe();
+				perf_end(subscribe_perf);
+			}
+		}
+	}
+
+	const hrt_abstime elapsed = hrt_elapsed_time(&start);
+
+	printf("subscribe all: %zu topics x %d instances (%d existing) in %" PRIu64 " us\n", orb_topics_count(),
+	       ORB_MULTI_MAX_INSTANCES, num_exists, elapsed);
+
+	perf_print_counter(exists_perf);
+	perf_print_counter(subscribe_perf);
+	perf_free(exists_perf);
+	perf_free(subscribe_perf);
+
+	return true;
+}
+
+#if defined(__PX4_POSIX)
+template<typename T>
+struct ReaderContext {
+	const orb_metadata *meta{nullptr};
+	px4::atomic_bool *run{nullptr};
+	perf_counter_t perf{nullptr};
+	char name[64] {};
+};
+
+template<typename T>
+static void *reader_thread(void *arg)
+{
+	ReaderContext<T> *context = static_cast<ReaderContext<T> *>(arg);
+
+	uORB::Subscription sub{context->meta};
+	T data{};
+
+	// copy as fast as possible to maximize contention with the publisher
+	while (context->run->load()) {
+		perf_begin(context->perf);
+		sub.copy(&data);
+		perf_end(context->perf);
+	}
+
+	return nullptr;
+}
+
+template<typename T>
+void MicroBenchORB::publish_with_readers(const orb_metadata *meta, int num_readers)
+{
+	static constexpr int MAX_READERS = 8;
+	num_readers = (num_readers > MAX_READERS) ? MAX_READERS : num_readers;
+
+	uORB::Publication<T> pub{meta};
+	T data{};
+	pub.publish(data);
+
+	px4::atomic_bool run{true};
+	pthread_t threads[MAX_READERS] {};
+	ReaderContext<T> contexts[MAX_READERS] {};
+
+	for (int i = 0; i < num_readers; i++) {
+		snprintf(contexts[i].name, sizeof(contexts[i].name), "%s copy (%d readers) reader %d", meta->o_name, num_readers, i);
+		contexts[i].meta = meta;
+		contexts[i].run = &run;
+		contexts[i].perf = perf_alloc(PC_ELAPSED, contexts[i].name);
+		pthread_create(&threads[i], nullptr, &reader_thread<T>, &contexts[i]);
+	}
+
+	char name[64];
+	snprintf(name, sizeof(name), "%s publish (%d readers)", meta->o_name, num_readers);
+	perf_counter_t perf_publish = perf_alloc(PC_ELAPSED, name);
+
+	// publish at ~1 kHz like a high rate sensor topic
+	for (int i = 0; i < 1000; i++) {
+		data.timestamp = hrt_absolute_time();
+		data.val = i;
+
+		perf_begin(perf_publish);
+		pub.publish(data);
+		perf_end(perf_publish);
+
+		px4_usleep(1000);
+	}
+
+	run.store(false);
+
+	for (int i = 0; i < num_readers; i++) {
+		pthread_join(threads[i], nullptr);
+	}
+
+	perf_print_counter(perf_publish);
+	perf_free(perf_publish);
+
+	for (int i = 0; i < num_readers; i++) {
+		perf_print_counter(contexts[i].perf);
+		perf_free(contexts[i].perf);
+	}
+
+	printf("\n");
+}
+
+bool MicroBenchORB::time_px4_uorb_contended()
+{
+	static constexpr int reader_counts[] {0, 1, 2, 4, 8};
+
+	for (int num_readers : reader_counts) {
+		publish_with_readers<orb_test_medium_s>(ORB_ID(orb_test_medium_queue), num_readers);
+	}
+
+	for (int num_readers : reader_counts) {
+		publish_with_readers<orb_test_large_s>(ORB_ID(orb_test_large), num_readers);
+	}
+
+	return true;
+}
+#endif // __PX4_POSIX
+
 } // namespace MicroBenchORB
@@ -31,6 +31,7 @@
  *
  ****************************************************************************/
 
+#include <stdlib.h>
 #include <string.h>
 
 #include <uORB/uORB.h>
@@ -57,6 +58,16 @@ int uorb_main(int argc, char *argv[])
 
 	} else if (!strcmp(argv[1], "top")) {
 		return uorb_top(argv + 2, argc - 2);
+
+	} else if (!strcmp(argv[1], "shm") && (argc >= 3)) {
+		const int instance = (argc >= 4) ? atoi(argv[3]) : 0;
+
+		if ((instance < 0) || (instance >= ORB_MULTI_MAX_INSTANCES)) {
+			PX4_ERR("invalid instance %d", instance);
+			return -1;
+		}
+
+		return uorb_shm(argv[2], instance);
 	}
 
 	usage();
@@ -84,6 +95,16 @@ modules are allowed to publish which topics. This is used for system-wide replay
 ### Examples
 Monitor topic publication rates. Besides `top`, this is an important command for general system inspection:
 $ uorb top
+
+With CONFIG_ORB_PROFILING, `top` also shows the subscriber copies per publication, the publish to copy latency
+of the latest message and the rate of publications that were never copied by any subscriber.
+The statistics can be written to a CSV file for offline analysis and published as orb_topic_statistics:
+$ uorb top -a -c /fs/microsd/orb_top.csv -p
+
+If compiled with CONFIG_ORB_SHM (Linux), the message queue of a topic can be placed in shared memory, so
+other processes on the same computer can publish and subscribe without any serialization
+(see uORBSharedMemory.hpp). This must be done before the topic is published, eg. at the start of the startup script:
+$ uorb shm vehicle_visual_odometry
 )DESCR_STR");
 
 	PRINT_MODULE_USAGE_NAME("uorb", "communication");
@@ -91,5 +112,9 @@ $ uorb top
 	PRINT_MODULE_USAGE_COMMAND_DESCR("top", "Monitor topic publication rates");
 	PRINT_MODULE_USAGE_PARAM_FLAG('a', "print all instead of only currently publishing topics with subscribers", true);
 	PRINT_MODULE_USAGE_PARAM_FLAG('1', "run only once, then exit", true);
+	PRINT_MODULE_USAGE_PARAM_FLAG('p', "publish the statistics as orb_topic_statistics", true);
+	PRINT_MODULE_USAGE_PARAM_STRING('c', nullptr, "<file>", "write the statistics to a CSV file", true);
 	PRINT_MODULE_USAGE_ARG("<filter1> [<filter2>]", "topic(s) to match (implies -a)", true);
+	PRINT_MODULE_USAGE_COMMAND_DESCR("shm", "Share a topic instance with other processes (CONFIG_ORB_SHM)");
+	PRINT_MODULE_USAGE_ARG("<topic> [<instance>]", "topic name and instance (default 0)", false);
 }
@@ -45,6 +45,25 @@ extern "C" {
 int
 work_queue_main(int argc, char *argv[])
 {
+	if (argc == 4 && !strcmp(argv[1], "affinity")) {
+		char *end = nullptr;
+		const unsigned long cpu_mask = strtoul(argv[3], &end, 0);
+
+		if ((end == argv[3]) || (*end != '\0') || (cpu_mask > UINT32_MAX)) {
+			PX4_ERR("invalid cpu mask %s", argv[3]);
+			return 1;
+		}
+
+		const int ret = px4::WorkQueueSetAffinity(argv[2], cpu_mask);
+
+		if (ret != PX4_OK) {
+			PX4_ERR("setting affinity of %s failed (%i)", argv[2], ret);
+			return 1;
+		}
+
+		return 0;
+	}
+
 	if (argc != 2) {
 		usage();
 		return 1;
@@ -78,9 +97,23 @@ usage()
 
 Command-line tool to show work queue status.
 
+On POSIX (Linux) work queue threads and module tasks can be pinned to a set of CPU cores.
+The mask applies to running threads and is remembered for threads started later,
+so it can be set in the startup script before the module is started.
+The logger's file writer thread (log_writer_file) picks up its mask when the logger is started.
+
+### Examples
+
+Pin the rate controller work queue to core 2 and the logger to cores 0 and 1:
+$ work_queue affinity wq:rate_ctrl 0x4
+$ work_queue affinity log_writer_file 0x3
+
 )DESCR_STR");
 
 	PRINT_MODULE_USAGE_NAME("work_queue", "system");
 	PRINT_MODULE_USAGE_COMMAND("start");
+	PRINT_MODULE_USAGE_COMMAND_DESCR("affinity", "Set the CPU affinity of a work queue or task (POSIX only)");
+	PRINT_MODULE_USAGE_ARG("<name>", "Work queue or task name, eg. wq:rate_ctrl", false);
+	PRINT_MODULE_USAGE_ARG("<mask>", "CPU mask, eg. 0x4 for core 2 (0: no restriction)", false);
 	PRINT_MODULE_USAGE_DEFAULT_COMMANDS();
 }